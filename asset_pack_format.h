@@ -0,0 +1,34 @@
+#ifndef ASSET_PACK_FORMAT_H
+#define ASSET_PACK_FORMAT_H
+
+#include <cstdint>
+
+// On-disk layout of the asset pack built by asset_packer and mapped by
+// the game. A pack is one AssetPackHeader, an array of AssetPackEntry
+// sorted by name, then the file contents, each aligned to
+// ASSET_PACK_ALIGNMENT. All fields are little-endian.
+
+const char ASSET_PACK_MAGIC[4] = {'C', 'R', 'P', 'K'};
+const uint32_t ASSET_PACK_VERSION = 1;
+const uint32_t ASSET_PACK_ALIGNMENT = 16;
+const int ASSET_NAME_LENGTH = 64;
+
+#pragma pack(push, 1)
+struct AssetPackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct AssetPackEntry {
+    char name[ASSET_NAME_LENGTH];  // Zero-terminated file name without directories
+    uint64_t offset;               // From the start of the pack
+    uint64_t size;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(AssetPackHeader) == 16, "AssetPackHeader must stay 16 bytes");
+static_assert(sizeof(AssetPackEntry) == 80, "AssetPackEntry must stay 80 bytes");
+
+#endif // ASSET_PACK_FORMAT_H
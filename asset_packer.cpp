@@ -0,0 +1,101 @@
+// Build step that packs the game's fonts and images into one archive.
+// Usage: asset_packer assets.pak office_worker.png Roboto-VariableFont_wdth,wght.ttf
+//
+// Entries are stored under their file name without directories, which
+// is the name the game looks them up by.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "asset_pack_format.h"
+
+struct PendingAsset {
+    std::string name;
+    std::vector<char> contents;
+};
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+uint64_t alignUp(uint64_t value) {
+    return (value + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+}
+
+int main(int argc, char* args[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << args[0] << " <output pack> <asset>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<PendingAsset> assets;
+    for (int i = 2; i < argc; i++) {
+        PendingAsset asset;
+        asset.name = baseName(args[i]);
+        if (asset.name.size() >= static_cast<size_t>(ASSET_NAME_LENGTH)) {
+            std::cerr << asset.name << ": name longer than " << ASSET_NAME_LENGTH - 1 << " characters" << std::endl;
+            return 1;
+        }
+
+        std::ifstream file(args[i], std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << args[i] << ": could not open" << std::endl;
+            return 1;
+        }
+        asset.contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        assets.push_back(asset);
+    }
+
+    // Sorted entries let the game binary-search the table
+    std::sort(assets.begin(), assets.end(), [](const PendingAsset& a, const PendingAsset& b) {
+        return a.name < b.name;
+    });
+    for (size_t i = 1; i < assets.size(); i++) {
+        if (assets[i].name == assets[i - 1].name) {
+            std::cerr << assets[i].name << ": listed twice" << std::endl;
+            return 1;
+        }
+    }
+
+    AssetPackHeader header = {};
+    std::memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = static_cast<uint32_t>(assets.size());
+
+    std::vector<AssetPackEntry> entries(assets.size());
+    uint64_t offset = alignUp(sizeof(AssetPackHeader) + entries.size() * sizeof(AssetPackEntry));
+    for (size_t i = 0; i < assets.size(); i++) {
+        std::memset(&entries[i], 0, sizeof(AssetPackEntry));
+        std::strncpy(entries[i].name, assets[i].name.c_str(), ASSET_NAME_LENGTH - 1);
+        entries[i].offset = offset;
+        entries[i].size = assets[i].contents.size();
+        offset = alignUp(offset + entries[i].size);
+    }
+
+    std::ofstream pack(args[1], std::ios::binary);
+    if (!pack.is_open()) {
+        std::cerr << args[1] << ": could not create" << std::endl;
+        return 1;
+    }
+    pack.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pack.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetPackEntry));
+    for (size_t i = 0; i < assets.size(); i++) {
+        std::vector<char> padding(entries[i].offset - static_cast<uint64_t>(pack.tellp()), 0);
+        pack.write(padding.data(), padding.size());
+        pack.write(assets[i].contents.data(), assets[i].contents.size());
+        std::cout << "  " << assets[i].name << " (" << entries[i].size << " bytes)" << std::endl;
+    }
+    if (!pack) {
+        std::cerr << args[1] << ": write failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << assets.size() << " assets into " << args[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,373 @@
+// Batch environment: many headless games stepped together.
+//
+// Per-game state is kept as structure-of-arrays so the per-frame physics
+// and collision test run four games at a time in SSE2 lanes. Only the
+// rare events, such as an obstacle passing the player or a crash, drop
+// to a scalar path for the affected game.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "batch_env.h"
+#include "course.h"
+#include "swept_collision.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BATCH_ENV_SSE2 1
+#endif
+
+namespace {
+
+const int LANE_WIDTH = 4;
+const float PLAYER_GROUND_Y = static_cast<float>(GROUND_LEVEL - PLAYER_HEIGHT);
+const float JUMP_POINTS = static_cast<float>(JUMP_SCORE);
+
+}
+
+struct BatchEnv {
+    int count;        // Games visible through the API
+    int laneCount;    // count rounded up to the SIMD width
+
+    // Hot state, one entry per lane
+    std::vector<float> y;
+    std::vector<float> velocity;
+    std::vector<float> jumping;    // 1.0f while airborne
+    std::vector<float> scored;     // 1.0f once this jump has scored
+    std::vector<float> score;
+    std::vector<float> scoreMod;   // score % SPEED_UP_SCORE, avoids an integer modulo in SIMD
+    std::vector<float> speed;
+    std::vector<float> obstacleX[2];      // Nearest two obstacles not yet passed
+    std::vector<float> obstacleWidth[2];
+    std::vector<float> obstacleHeight[2];
+
+    // Cold state, only touched on the scalar path
+    std::vector<uint64_t> baseSeed;
+    std::vector<uint64_t> runIndex;
+    std::vector<uint64_t> courseSeed;
+    std::vector<uint64_t> nextObstacle;   // Course index of the obstacle after the second one
+    std::vector<int64_t> secondCourseX;   // Course position of obstacleX[1]
+
+    explicit BatchEnv(int games)
+        : count(games), laneCount((games + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH),
+          y(laneCount), velocity(laneCount), jumping(laneCount), scored(laneCount), score(laneCount),
+          scoreMod(laneCount), speed(laneCount), baseSeed(laneCount), runIndex(laneCount),
+          courseSeed(laneCount), nextObstacle(laneCount), secondCourseX(laneCount) {
+        for (int slot = 0; slot < 2; slot++) {
+            obstacleX[slot].resize(laneCount);
+            obstacleWidth[slot].resize(laneCount);
+            obstacleHeight[slot].resize(laneCount);
+        }
+    }
+
+    void setObstacle(int lane, int slot, const CourseObstacle& obstacle, float x) {
+        obstacleX[slot][lane] = x;
+        obstacleWidth[slot][lane] = static_cast<float>(OBSTACLE_SIZES[obstacle.type][0]);
+        obstacleHeight[slot][lane] = static_cast<float>(OBSTACLE_SIZES[obstacle.type][1]);
+    }
+
+    // Same starting state as Game::resetGame with no start distance
+    void resetLane(int lane) {
+        y[lane] = PLAYER_GROUND_Y;
+        velocity[lane] = 0.0f;
+        jumping[lane] = 0.0f;
+        scored[lane] = 0.0f;
+        score[lane] = 0.0f;
+        scoreMod[lane] = 0.0f;
+        speed[lane] = static_cast<float>(GAME_SPEED_INITIAL);
+
+        uint64_t seed = runIndex[lane] == 0 ? baseSeed[lane] : nextRunSeed(baseSeed[lane], runIndex[lane]);
+        courseSeed[lane] = seed;
+        uint64_t first = firstCourseObstacleFrom(seed, PLAYER_X + PLAYER_WIDTH + START_SAFE_DISTANCE);
+        CourseObstacle nearest = courseObstacle(seed, first);
+        CourseObstacle second = courseObstacle(seed, first + 1);
+        setObstacle(lane, 0, nearest, static_cast<float>(nearest.courseX));
+        setObstacle(lane, 1, second, static_cast<float>(second.courseX));
+        secondCourseX[lane] = second.courseX;
+        nextObstacle[lane] = first + 2;
+    }
+
+    // The nearest obstacle is behind the player for good: slide the next one in
+    void advanceObstacles(int lane) {
+        CourseObstacle next = courseObstacle(courseSeed[lane], nextObstacle[lane]++);
+        float nextX = obstacleX[1][lane] + static_cast<float>(next.courseX - secondCourseX[lane]);
+        obstacleX[0][lane] = obstacleX[1][lane];
+        obstacleWidth[0][lane] = obstacleWidth[1][lane];
+        obstacleHeight[0][lane] = obstacleHeight[1][lane];
+        setObstacle(lane, 1, next, nextX);
+        secondCourseX[lane] = next.courseX;
+    }
+
+    bool nearestPassed(int lane) const {
+        return static_cast<int>(obstacleX[0][lane]) + obstacleWidth[0][lane] <= PLAYER_X;
+    }
+
+    // Fix-ups after the vectorized step; returns the done flag
+    uint8_t finishLane(int lane, bool crashed) {
+        if (crashed) {
+            runIndex[lane]++;
+            resetLane(lane);
+            return 1;
+        }
+        while (nearestPassed(lane)) {
+            advanceObstacles(lane);
+        }
+        return 0;
+    }
+
+    // Reference implementation of one frame, mirrors Game::update
+    void stepLaneScalar(int lane, bool jump, float& reward, bool& crashed) {
+        int playerTopStart = static_cast<int>(y[lane]);
+        if (jump && jumping[lane] == 0.0f) {
+            jumping[lane] = 1.0f;
+            velocity[lane] = JUMP_VELOCITY;
+            scored[lane] = 0.0f;
+        }
+
+        if (jumping[lane] != 0.0f) {
+            velocity[lane] += GRAVITY;
+            y[lane] += velocity[lane];
+            if (y[lane] >= PLAYER_GROUND_Y) {
+                y[lane] = PLAYER_GROUND_Y;
+                velocity[lane] = 0.0f;
+                jumping[lane] = 0.0f;
+                scored[lane] = 0.0f;
+            }
+        }
+
+        reward = 0.0f;
+        if (jumping[lane] != 0.0f && scored[lane] == 0.0f && velocity[lane] > -2.0f && velocity[lane] < 2.0f) {
+            scored[lane] = 1.0f;
+            score[lane] += JUMP_POINTS;
+            scoreMod[lane] += JUMP_POINTS;
+            if (scoreMod[lane] >= SPEED_UP_SCORE) {
+                scoreMod[lane] -= SPEED_UP_SCORE;
+            }
+            reward = JUMP_POINTS;
+
+            if (scoreMod[lane] == 0.0f) {
+                speed[lane] += GAME_SPEED_INCREMENT;
+            }
+        }
+
+        int playerTopEnd = static_cast<int>(y[lane]);
+        crashed = false;
+        for (int slot = 0; slot < 2; slot++) {
+            int leftStart = static_cast<int>(obstacleX[slot][lane]);
+            obstacleX[slot][lane] -= speed[lane];
+            float impact;
+            if (sweptPlayerHit(playerTopStart, playerTopEnd, leftStart, static_cast<int>(obstacleX[slot][lane]),
+                               static_cast<int>(obstacleWidth[slot][lane]),
+                               static_cast<int>(obstacleHeight[slot][lane]), impact)) {
+                crashed = true;
+            }
+        }
+    }
+
+#ifdef BATCH_ENV_SSE2
+    // sweptAxisInterval for four lanes, including its static-overlap case
+    static void sweptAxisSimd(__m128 movingMin, __m128 movingSize, __m128 move, __m128 staticMin, __m128 staticSize,
+                              __m128& enter, __m128& exit) {
+        const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        __m128 still = _mm_cmpeq_ps(move, _mm_setzero_ps());
+        __m128 overlap = _mm_and_ps(_mm_cmplt_ps(movingMin, _mm_add_ps(staticMin, staticSize)),
+                                    _mm_cmplt_ps(staticMin, _mm_add_ps(movingMin, movingSize)));
+        __m128 stillEnter = _mm_or_ps(_mm_and_ps(overlap, _mm_sub_ps(_mm_setzero_ps(), infinity)),
+                                      _mm_andnot_ps(overlap, infinity));
+        __m128 stillExit = _mm_or_ps(_mm_and_ps(overlap, infinity),
+                                     _mm_andnot_ps(overlap, _mm_sub_ps(_mm_setzero_ps(), infinity)));
+
+        // Lanes that do not move divide by one instead; their result is replaced below
+        __m128 safeMove = _mm_or_ps(_mm_and_ps(still, _mm_set1_ps(1.0f)), _mm_andnot_ps(still, move));
+        __m128 inverseMove = _mm_div_ps(_mm_set1_ps(1.0f), safeMove);
+        __m128 toFarEdge = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(staticMin, staticSize), movingMin), inverseMove);
+        __m128 toNearEdge = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(staticMin, movingSize), movingMin), inverseMove);
+        enter = _mm_or_ps(_mm_and_ps(still, stillEnter), _mm_andnot_ps(still, _mm_min_ps(toNearEdge, toFarEdge)));
+        exit = _mm_or_ps(_mm_and_ps(still, stillExit), _mm_andnot_ps(still, _mm_max_ps(toNearEdge, toFarEdge)));
+    }
+
+    // Four lanes of stepLaneScalar; returns a bitmask of lanes that need finishLane
+    int stepLanesSimd(int lane, const uint8_t* actions, float* laneRewards, int& crashedMask) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 groundY = _mm_set1_ps(PLAYER_GROUND_Y);
+
+        // Padding lanes past count never jump
+        uint8_t laneActions[LANE_WIDTH] = {};
+        for (int i = 0; i < LANE_WIDTH && lane + i < count; i++) {
+            laneActions[i] = actions[lane + i];
+        }
+        __m128 jumpRequested = _mm_cmpneq_ps(
+            _mm_set_ps(laneActions[3], laneActions[2], laneActions[1], laneActions[0]), zero);
+
+        __m128 v = _mm_loadu_ps(&velocity[lane]);
+        __m128 py = _mm_loadu_ps(&y[lane]);
+        __m128 playerTopStart = _mm_cvtepi32_ps(_mm_cvttps_epi32(py));
+        __m128 air = _mm_cmpneq_ps(_mm_loadu_ps(&jumping[lane]), zero);
+        __m128 hasScored = _mm_cmpneq_ps(_mm_loadu_ps(&scored[lane]), zero);
+
+        // Jump input
+        __m128 takeOff = _mm_andnot_ps(air, jumpRequested);
+        v = _mm_or_ps(_mm_and_ps(takeOff, _mm_set1_ps(JUMP_VELOCITY)), _mm_andnot_ps(takeOff, v));
+        air = _mm_or_ps(air, takeOff);
+        hasScored = _mm_andnot_ps(takeOff, hasScored);
+
+        // Gravity and landing
+        __m128 newV = _mm_add_ps(v, _mm_set1_ps(GRAVITY));
+        __m128 newY = _mm_add_ps(py, newV);
+        __m128 landed = _mm_and_ps(air, _mm_cmpge_ps(newY, groundY));
+        __m128 flying = _mm_andnot_ps(landed, air);
+        py = _mm_or_ps(_mm_or_ps(_mm_and_ps(flying, newY), _mm_and_ps(landed, groundY)), _mm_andnot_ps(air, py));
+        v = _mm_or_ps(_mm_and_ps(flying, newV), _mm_andnot_ps(air, v));
+        hasScored = _mm_andnot_ps(landed, hasScored);
+        air = flying;
+
+        // Jump scoring at the top of the arc
+        __m128 nearApex = _mm_and_ps(_mm_cmpgt_ps(v, _mm_set1_ps(-2.0f)), _mm_cmplt_ps(v, _mm_set1_ps(2.0f)));
+        __m128 scoreNow = _mm_andnot_ps(hasScored, _mm_and_ps(air, nearApex));
+        hasScored = _mm_or_ps(hasScored, scoreNow);
+        __m128 points = _mm_and_ps(scoreNow, _mm_set1_ps(JUMP_POINTS));
+        __m128 total = _mm_add_ps(_mm_loadu_ps(&score[lane]), points);
+        __m128 mod = _mm_add_ps(_mm_loadu_ps(&scoreMod[lane]), points);
+        __m128 wrap = _mm_cmpge_ps(mod, _mm_set1_ps(static_cast<float>(SPEED_UP_SCORE)));
+        mod = _mm_sub_ps(mod, _mm_and_ps(wrap, _mm_set1_ps(static_cast<float>(SPEED_UP_SCORE))));
+
+        // Speed-up when a jump lands the score on a multiple of SPEED_UP_SCORE
+        __m128 speedUp = _mm_and_ps(scoreNow, _mm_cmpeq_ps(mod, zero));
+        __m128 s = _mm_add_ps(_mm_loadu_ps(&speed[lane]),
+                              _mm_and_ps(speedUp, _mm_set1_ps(static_cast<float>(GAME_SPEED_INCREMENT))));
+
+        // Move obstacles and sweep both against the player hitbox, as sweptPlayerHit
+        __m128 playerTopEnd = _mm_cvtepi32_ps(_mm_cvttps_epi32(py));
+        __m128 playerMove = _mm_sub_ps(playerTopEnd, playerTopStart);
+        __m128 playerX = _mm_set1_ps(static_cast<float>(PLAYER_X));
+        __m128 playerWidth = _mm_set1_ps(static_cast<float>(PLAYER_WIDTH));
+        __m128 playerHeight = _mm_set1_ps(static_cast<float>(PLAYER_HEIGHT));
+        __m128 ground = _mm_set1_ps(static_cast<float>(GROUND_LEVEL));
+        __m128i playerLeft = _mm_set1_epi32(PLAYER_X);
+        __m128 hit = zero;
+        __m128i passed = _mm_setzero_si128();
+        for (int slot = 0; slot < 2; slot++) {
+            __m128 oldX = _mm_loadu_ps(&obstacleX[slot][lane]);
+            __m128 ox = _mm_sub_ps(oldX, s);
+            _mm_storeu_ps(&obstacleX[slot][lane], ox);
+            __m128i left = _mm_cvttps_epi32(ox);
+            __m128 leftStart = _mm_cvtepi32_ps(_mm_cvttps_epi32(oldX));
+            __m128 width = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_loadu_ps(&obstacleWidth[slot][lane])));
+            __m128 height = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_loadu_ps(&obstacleHeight[slot][lane])));
+
+            __m128 enterX, exitX, enterY, exitY;
+            sweptAxisSimd(playerX, playerWidth, _mm_sub_ps(leftStart, _mm_cvtepi32_ps(left)),
+                          leftStart, width, enterX, exitX);
+            sweptAxisSimd(playerTopStart, playerHeight, playerMove, _mm_sub_ps(ground, height), height, enterY, exitY);
+            __m128 first = _mm_max_ps(_mm_max_ps(enterX, enterY), zero);
+            __m128 last = _mm_min_ps(_mm_min_ps(exitX, exitY), one);
+            hit = _mm_or_ps(hit, _mm_cmplt_ps(first, last));
+
+            if (slot == 0) {
+                // right <= PLAYER_X, written as not(right > PLAYER_X)
+                __m128i right = _mm_add_epi32(left, _mm_cvttps_epi32(width));
+                passed = _mm_xor_si128(_mm_cmpgt_epi32(right, playerLeft), _mm_set1_epi32(-1));
+            }
+        }
+
+        _mm_storeu_ps(&velocity[lane], v);
+        _mm_storeu_ps(&y[lane], py);
+        _mm_storeu_ps(&jumping[lane], _mm_and_ps(air, one));
+        _mm_storeu_ps(&scored[lane], _mm_and_ps(hasScored, one));
+        _mm_storeu_ps(&score[lane], total);
+        _mm_storeu_ps(&scoreMod[lane], mod);
+        _mm_storeu_ps(&speed[lane], s);
+        _mm_storeu_ps(laneRewards, points);
+
+        crashedMask = _mm_movemask_ps(hit);
+        return _mm_movemask_ps(_mm_or_ps(hit, _mm_castsi128_ps(passed)));
+    }
+#endif
+
+    void writeObservation(int lane, float* out) const {
+        out[0] = y[lane];
+        out[1] = velocity[lane];
+        out[2] = speed[lane];
+        for (int slot = 0; slot < 2; slot++) {
+            // Obstacles beyond the right edge have not spawned in the real game yet
+            bool visible = obstacleX[slot][lane] <= SCREEN_WIDTH;
+            float* fields = out + 3 + slot * 3;
+            fields[0] = visible ? obstacleX[slot][lane] : static_cast<float>(SCREEN_WIDTH);
+            if (slot == 0) {
+                fields[1] = visible ? obstacleWidth[slot][lane] : 0.0f;
+                fields[2] = visible ? obstacleHeight[slot][lane] : 0.0f;
+            } else {
+                fields[1] = visible ? obstacleHeight[slot][lane] : 0.0f;
+            }
+        }
+    }
+};
+
+extern "C" {
+
+BatchEnv* batch_env_create(int count) {
+    if (count <= 0) {
+        return nullptr;
+    }
+    return new BatchEnv(count);
+}
+
+void batch_env_destroy(BatchEnv* env) {
+    delete env;
+}
+
+int batch_env_count(const BatchEnv* env) {
+    return env->count;
+}
+
+void batch_env_reset(BatchEnv* env, const uint64_t* seeds, float* observations) {
+    for (int lane = 0; lane < env->laneCount; lane++) {
+        env->baseSeed[lane] = lane < env->count ? seeds[lane] : 0;
+        env->runIndex[lane] = 0;
+        env->resetLane(lane);
+        if (lane < env->count) {
+            env->writeObservation(lane, observations + lane * BATCH_ENV_OBSERVATION_SIZE);
+        }
+    }
+}
+
+void batch_env_step(BatchEnv* env, const uint8_t* actions, float* observations, float* rewards, uint8_t* dones) {
+    // Rewards are written a whole lane group at a time, so stage them when
+    // the caller's buffer is not a multiple of the lane width
+    float laneRewards[LANE_WIDTH];
+
+    for (int lane = 0; lane < env->laneCount; lane += LANE_WIDTH) {
+        int visible = std::min(LANE_WIDTH, env->count - lane);
+        int crashedMask = 0;
+#ifdef BATCH_ENV_SSE2
+        int fixupMask = env->stepLanesSimd(lane, actions, laneRewards, crashedMask);
+#else
+        int fixupMask = 0;
+        for (int i = 0; i < LANE_WIDTH; i++) {
+            bool crashed = false;
+            bool jump = i < visible && actions[lane + i] != 0;
+            env->stepLaneScalar(lane + i, jump, laneRewards[i], crashed);
+            crashedMask |= crashed ? 1 << i : 0;
+            fixupMask |= crashed || env->nearestPassed(lane + i) ? 1 << i : 0;
+        }
+#endif
+        for (int i = 0; i < visible; i++) {
+            uint8_t done = 0;
+            if (fixupMask & (1 << i)) {
+                done = env->finishLane(lane + i, (crashedMask & (1 << i)) != 0);
+            }
+            rewards[lane + i] = laneRewards[i];
+            dones[lane + i] = done;
+            env->writeObservation(lane + i, observations + (lane + i) * BATCH_ENV_OBSERVATION_SIZE);
+        }
+        for (int i = visible; i < LANE_WIDTH; i++) {
+            if (fixupMask & (1 << i)) {
+                env->finishLane(lane + i, (crashedMask & (1 << i)) != 0);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,53 @@
+#ifndef BATCH_ENV_H
+#define BATCH_ENV_H
+
+/*
+ * Headless batch environment for training agents. It steps many
+ * independent games per call with the same physics, scoring and
+ * collision rules as Game, and the same courses for the same seeds.
+ *
+ * Build as a shared library:
+ *   g++ -O3 -shared -fPIC batch_env.cpp -o batch_env.dll
+ */
+
+#include <stdint.h>
+
+#ifdef _WIN32
+#define BATCH_ENV_API __declspec(dllexport)
+#else
+#define BATCH_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Floats per game in the observation buffer:
+ * player y, player velocity, game speed,
+ * nearest obstacle x, width, height,
+ * second obstacle x, height.
+ * Obstacles not yet on screen read as x = 800 with zero size. */
+#define BATCH_ENV_OBSERVATION_SIZE 8
+
+typedef struct BatchEnv BatchEnv;
+
+BATCH_ENV_API BatchEnv* batch_env_create(int count);
+BATCH_ENV_API void batch_env_destroy(BatchEnv* env);
+BATCH_ENV_API int batch_env_count(const BatchEnv* env);
+
+/* Starts a new run in every game. seeds[count] picks each course;
+ * observations receives count * BATCH_ENV_OBSERVATION_SIZE floats. */
+BATCH_ENV_API void batch_env_reset(BatchEnv* env, const uint64_t* seeds, float* observations);
+
+/* Advances every game by one frame. A non-zero actions[i] presses jump.
+ * rewards[i] is the score gained this frame and dones[i] is 1 when game
+ * i crashed. A crashed game restarts at once on a new course derived from
+ * its seed, and its observation is the first frame of that run. */
+BATCH_ENV_API void batch_env_step(BatchEnv* env, const uint8_t* actions, float* observations,
+                                  float* rewards, uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BATCH_ENV_H */
@@ -0,0 +1,63 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+
+// Counter-based random numbers: every value is a pure function of
+// (seed, stream, counter), so any point of the course can be generated
+// directly, out of order or from several threads, without replaying a
+// sequential generator. Built on Widynski's "Squares" generator.
+
+enum RngStream : uint32_t {
+    RNG_STREAM_OBSTACLES = 1,
+    RNG_STREAM_SKYLINE,
+    RNG_STREAM_WINDOWS,
+    RNG_STREAM_FAR_SKYLINE,
+    RNG_STREAM_CLOUDS,
+    RNG_STREAM_BOTS
+};
+
+inline uint64_t splitMix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+inline uint32_t squares32(uint64_t counter, uint64_t key) {
+    uint64_t x = counter * key;
+    uint64_t y = x;
+    uint64_t z = y + key;
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    x = x * x + z; x = (x >> 32) | (x << 32);
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    return static_cast<uint32_t>((x * x + z) >> 32);
+}
+
+class CounterRng {
+private:
+    uint64_t key;
+
+public:
+    static const uint32_t LANES = 8;  // Independent draws available per counter value
+
+    CounterRng(uint64_t seed, RngStream stream)
+        : key(splitMix64(seed ^ splitMix64(stream)) | 1) {}  // Squares wants an odd key
+
+    uint32_t bits(uint64_t counter, uint32_t lane = 0) const {
+        return squares32(counter * LANES + lane, key);
+    }
+
+    // Uniform integer in [low, high]
+    int range(uint64_t counter, uint32_t lane, int low, int high) const {
+        uint64_t span = static_cast<uint64_t>(high - low) + 1;
+        return low + static_cast<int>((static_cast<uint64_t>(bits(counter, lane)) * span) >> 32);
+    }
+
+    // True with probability numerator / denominator
+    bool chance(uint64_t counter, uint32_t lane, int numerator, int denominator) const {
+        return range(counter, lane, 0, denominator - 1) < numerator;
+    }
+};
+
+#endif // COUNTER_RNG_H
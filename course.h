@@ -0,0 +1,76 @@
+#ifndef COURSE_H
+#define COURSE_H
+
+#include <cstdint>
+
+#include "counter_rng.h"
+#include "game_constants.h"
+
+// The course is a pure function of its seed: obstacle `index` can be
+// computed without generating any of the ones before it. Shared by the
+// game and the batch environment so both see identical courses.
+
+struct CourseObstacle {
+    int64_t courseX;  // Distance at which the obstacle's left edge reaches x = 0
+    ObstacleType type;
+};
+
+// Every SET_PIECE_PERIOD obstacles the course ends on a set piece: a fixed
+// run the player learns to read instead of random ones. Each step keeps to
+// its segment, within COURSE_SPAWN_JITTER, so the course stays in order.
+struct SetPieceStep {
+    int offset;  // From the start of the obstacle's segment
+    ObstacleType type;
+};
+
+const SetPieceStep ROAD_WORKS[] = {
+    {0, FIRE_HYDRANT},
+    {-150, PUDDLE},     // Hard on the hydrant's heels
+    {-150, PUDDLE},
+    {150, TRASH_CAN},   // A breather before the bicycle
+    {0, BICYCLE}        // Not a car: at the starting speed a car on a segment start cannot be cleared
+};
+const uint64_t SET_PIECE_LENGTH = sizeof(ROAD_WORKS) / sizeof(ROAD_WORKS[0]);
+const uint64_t SET_PIECE_PERIOD = 40;
+
+inline bool isSetPieceObstacle(uint64_t index) {
+    return index % SET_PIECE_PERIOD >= SET_PIECE_PERIOD - SET_PIECE_LENGTH;
+}
+
+// Index of the first obstacle of the next set piece that starts at or after index
+inline uint64_t nextSetPieceFrom(uint64_t index) {
+    uint64_t start = index - index % SET_PIECE_PERIOD + SET_PIECE_PERIOD - SET_PIECE_LENGTH;
+    return start >= index ? start : start + SET_PIECE_PERIOD;
+}
+
+inline CourseObstacle courseObstacle(uint64_t seed, uint64_t index) {
+    CourseObstacle obstacle;
+    if (isSetPieceObstacle(index)) {
+        const SetPieceStep& step = ROAD_WORKS[index % SET_PIECE_PERIOD - (SET_PIECE_PERIOD - SET_PIECE_LENGTH)];
+        obstacle.courseX = SCREEN_WIDTH + static_cast<int64_t>(index + 1) * COURSE_SEGMENT_LENGTH + step.offset;
+        obstacle.type = step.type;
+        return obstacle;
+    }
+    CounterRng random(seed, RNG_STREAM_OBSTACLES);
+    obstacle.courseX = SCREEN_WIDTH + static_cast<int64_t>(index + 1) * COURSE_SEGMENT_LENGTH
+                     + random.range(index, 0, -COURSE_SPAWN_JITTER, COURSE_SPAWN_JITTER);
+    obstacle.type = static_cast<ObstacleType>(random.range(index, 1, 0, OBSTACLE_TYPE_COUNT - 1));
+    return obstacle;
+}
+
+// Index of the first obstacle at or beyond courseX
+inline uint64_t firstCourseObstacleFrom(uint64_t seed, int64_t courseX) {
+    int64_t segment = (courseX - SCREEN_WIDTH - COURSE_SPAWN_JITTER) / COURSE_SEGMENT_LENGTH - 1;
+    uint64_t index = segment > 0 ? static_cast<uint64_t>(segment) : 0;
+    while (courseObstacle(seed, index).courseX < courseX) {
+        index++;
+    }
+    return index;
+}
+
+// Seed of a run after the first when no fixed seed is given
+inline uint64_t nextRunSeed(uint64_t baseSeed, uint64_t runIndex) {
+    return splitMix64(baseSeed ^ splitMix64(runIndex));
+}
+
+#endif // COURSE_H
@@ -0,0 +1,138 @@
+// Build step that turns an authored course into the binary format the
+// game maps with --course.
+// Usage: course_builder <output> <course.txt>
+//        course_builder <output> --random <seed> <count>
+//
+// A text course has one obstacle per line, "<courseX> <TYPE> [<width> <height>]",
+// where TYPE is an ObstacleType name such as FIRE_HYDRANT and the size
+// defaults to that type's usual one. Blank lines and lines starting with
+// '#' are ignored. --random exports the first <count> obstacles of a seeded
+// course instead, which is handy as a starting point or for large tests.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "course.h"
+#include "course_format.h"
+
+const char* const OBSTACLE_TYPE_NAMES[OBSTACLE_TYPE_COUNT] = {
+    "COFFEE_CUP", "BRIEFCASE", "FIRE_HYDRANT", "TRASH_CAN", "CAR", "BICYCLE", "PUDDLE", "DOG"
+};
+
+CourseRecord makeRecord(int64_t courseX, int type, int width, int height) {
+    CourseRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.courseX = courseX;
+    record.type = static_cast<uint8_t>(type);
+    record.width = static_cast<uint16_t>(width);
+    record.height = static_cast<uint16_t>(height);
+    return record;
+}
+
+bool readTextCourse(const char* path, std::vector<CourseRecord>& records) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << path << ": could not open" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        int64_t courseX;
+        std::string typeName;
+        if (line.empty() || line[0] == '#' || !(fields >> courseX)) {
+            continue;
+        }
+        fields >> typeName;
+        const char* const* found = std::find(OBSTACLE_TYPE_NAMES, OBSTACLE_TYPE_NAMES + OBSTACLE_TYPE_COUNT, typeName);
+        if (found == OBSTACLE_TYPE_NAMES + OBSTACLE_TYPE_COUNT) {
+            std::cerr << path << ":" << lineNumber << ": unknown obstacle type '" << typeName << "'" << std::endl;
+            return false;
+        }
+        int type = static_cast<int>(found - OBSTACLE_TYPE_NAMES);
+        int width = OBSTACLE_SIZES[type][0];
+        int height = OBSTACLE_SIZES[type][1];
+        fields >> width >> height;
+        if (width <= 0 || height <= 0 || width > SCREEN_WIDTH || height > GROUND_LEVEL) {
+            std::cerr << path << ":" << lineNumber << ": bad obstacle size" << std::endl;
+            return false;
+        }
+        records.push_back(makeRecord(courseX, type, width, height));
+    }
+    return true;
+}
+
+int main(int argc, char* args[]) {
+    std::vector<CourseRecord> records;
+    if (argc == 5 && std::string(args[2]) == "--random") {
+        uint64_t seed = std::strtoull(args[3], nullptr, 10);
+        uint64_t count = std::strtoull(args[4], nullptr, 10);
+        records.reserve(count);
+        for (uint64_t index = 0; index < count; index++) {
+            CourseObstacle obstacle = courseObstacle(seed, index);
+            records.push_back(makeRecord(obstacle.courseX, obstacle.type,
+                                         OBSTACLE_SIZES[obstacle.type][0], OBSTACLE_SIZES[obstacle.type][1]));
+        }
+    } else if (argc == 3) {
+        if (!readTextCourse(args[2], records)) {
+            return 1;
+        }
+    } else {
+        std::cerr << "Usage: " << args[0] << " <output> <course.txt>" << std::endl;
+        std::cerr << "       " << args[0] << " <output> --random <seed> <count>" << std::endl;
+        return 1;
+    }
+
+    // Same check the game applies when it reads the course
+    for (const CourseRecord& record : records) {
+        if (!isPlayableRecord(record)) {
+            std::cerr << "Obstacle at " << record.courseX << " cannot be played" << std::endl;
+            return 1;
+        }
+    }
+
+    // The game seeks by binary search, so records must be in course order
+    std::stable_sort(records.begin(), records.end(), [](const CourseRecord& a, const CourseRecord& b) {
+        return a.courseX < b.courseX;
+    });
+
+    std::vector<int64_t> index;
+    for (size_t i = 0; i < records.size(); i += COURSE_INDEX_STRIDE) {
+        index.push_back(records[i].courseX);
+    }
+
+    CourseFileHeader header = {};
+    std::memcpy(header.magic, COURSE_FILE_MAGIC, sizeof(header.magic));
+    header.version = COURSE_FILE_VERSION;
+    header.recordCount = records.size();
+    header.indexOffset = sizeof(CourseFileHeader);
+    header.recordOffset = header.indexOffset + index.size() * sizeof(int64_t);
+    header.indexCount = static_cast<uint32_t>(index.size());
+    header.indexStride = COURSE_INDEX_STRIDE;
+
+    std::ofstream course(args[1], std::ios::binary);
+    if (!course.is_open()) {
+        std::cerr << args[1] << ": could not create" << std::endl;
+        return 1;
+    }
+    course.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    course.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(int64_t));
+    course.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CourseRecord));
+    if (!course) {
+        std::cerr << args[1] << ": write failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << records.size() << " obstacles (" << index.size() << " index entries) to "
+              << args[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef COURSE_FORMAT_H
+#define COURSE_FORMAT_H
+
+#include <cstdint>
+
+#include "game_constants.h"
+
+// On-disk layout of an authored course built by course_builder and mapped
+// by the game with --course. A course file is one CourseFileHeader, the
+// distance index, then the obstacle records sorted by courseX. Index entry
+// i holds the courseX of record i * indexStride, so finding the first
+// obstacle at or beyond a distance is a binary search of the index plus a
+// scan of at most one block. All fields are little-endian.
+
+const char COURSE_FILE_MAGIC[4] = {'C', 'R', 'C', 'S'};
+const uint32_t COURSE_FILE_VERSION = 1;
+const uint32_t COURSE_INDEX_STRIDE = 256;  // Records per index entry; one block is 4 KiB
+
+#pragma pack(push, 1)
+struct CourseFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t recordCount;
+    uint64_t indexOffset;   // From the start of the file
+    uint64_t recordOffset;
+    uint32_t indexCount;    // recordCount / indexStride, rounded up
+    uint32_t indexStride;
+};
+
+struct CourseRecord {
+    int64_t courseX;  // Distance at which the obstacle's left edge reaches x = 0
+    uint16_t width;
+    uint16_t height;
+    uint8_t type;     // ObstacleType, picks the artwork
+    uint8_t reserved[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(CourseFileHeader) == 40, "CourseFileHeader must stay 40 bytes");
+static_assert(sizeof(CourseRecord) == 16, "CourseRecord must stay 16 bytes");
+
+// Whether the game can place and draw a record: a known type, on screen
+// and standing on the ground
+inline bool isPlayableRecord(const CourseRecord& record) {
+    return record.type < OBSTACLE_TYPE_COUNT &&
+           record.width > 0 && record.width <= SCREEN_WIDTH &&
+           record.height > 0 && record.height <= GROUND_LEVEL;
+}
+
+#endif // COURSE_FORMAT_H
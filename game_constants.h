@@ -0,0 +1,63 @@
+#ifndef GAME_CONSTANTS_H
+#define GAME_CONSTANTS_H
+
+#include <string>
+
+// Game constants
+const int SCREEN_WIDTH = 800;
+const int SCREEN_HEIGHT = 400;
+const int GROUND_LEVEL = 300;
+const int PLAYER_X = 100;
+const int PLAYER_WIDTH = 50;
+const int PLAYER_HEIGHT = 80;
+const int OBSTACLE_WIDTH = 30;
+const int OBSTACLE_HEIGHT = 50;
+const int JUMP_VELOCITY = -16;
+const float GRAVITY = 0.8f;
+const int GAME_SPEED_INITIAL = 5;
+const int GAME_SPEED_INCREMENT = 1;
+const int JUMP_SCORE = 10;
+const int SPEED_UP_SCORE = 500;
+const int COURSE_SEGMENT_LENGTH = 600; // Course distance between consecutive obstacles
+const int COURSE_SPAWN_JITTER = 150;   // Random shift of each obstacle within its segment
+const int START_SAFE_DISTANCE = 400;   // Obstacle-free stretch ahead of the player when starting mid-course
+const std::string HIGH_SCORE_FILE = "highscore.dat";
+const std::string TELEMETRY_FILE_PREFIX = "telemetry_";
+const std::string TELEMETRY_FILE_EXTENSION = ".crtl";
+const std::string LEADERBOARD_QUEUE_FILE = "leaderboard_queue.dat"; // Scores waiting to be submitted
+const std::string GOLDEN_DIRECTORY = "golden/"; // Reference frames for --golden-check
+const std::string ASSET_PACK_FILE = "assets.pak"; // Built from the files below by asset_packer
+const std::string FONT_ASSET = "Roboto-VariableFont_wdth,wght.ttf";
+const std::string CHARACTER_ASSET = "office_worker.png";
+#ifdef _WIN32
+const std::string BATCH_ENV_LIBRARY = "batch_env.dll"; // Loaded by --golden-check to run in lockstep with the game
+#else
+const std::string BATCH_ENV_LIBRARY = "./batch_env.so";
+#endif
+
+// Obstacle types
+enum ObstacleType {
+    COFFEE_CUP,
+    BRIEFCASE,
+    FIRE_HYDRANT,
+    TRASH_CAN,
+    CAR,
+    BICYCLE,
+    PUDDLE,
+    DOG,
+    OBSTACLE_TYPE_COUNT
+};
+
+// Width and height of each obstacle type
+const int OBSTACLE_SIZES[OBSTACLE_TYPE_COUNT][2] = {
+    {30, 40},   // COFFEE_CUP
+    {50, 30},   // BRIEFCASE
+    {40, 60},   // FIRE_HYDRANT
+    {45, 70},   // TRASH_CAN
+    {100, 60},  // CAR
+    {70, 50},   // BICYCLE
+    {80, 5},    // PUDDLE
+    {60, 40}    // DOG
+};
+
+#endif // GAME_CONSTANTS_H
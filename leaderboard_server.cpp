@@ -0,0 +1,114 @@
+// Local stand-in for the leaderboard service.
+// Usage: leaderboard_server [--port 8085] [--delay-ms N] [--dead]
+//
+// Speaks just enough HTTP/1.0 for the game's LeaderboardClient:
+//   POST /scores  body: one "<name> <score>" per line
+//   GET /top?n=N  reply: the best N as "<name> <score>" lines
+// --delay-ms holds every reply back to imitate a slow service, and
+// --dead accepts connections but never answers.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "net_socket.h"
+
+struct Entry {
+    std::string name;
+    unsigned int score;
+};
+
+void sleepMs(int milliseconds) {
+#ifdef _WIN32
+    Sleep(static_cast<DWORD>(milliseconds));
+#else
+    usleep(static_cast<useconds_t>(milliseconds) * 1000);
+#endif
+}
+
+std::string respond(const std::string& request, std::vector<Entry>& entries) {
+    size_t bodyStart = request.find("\r\n\r\n");
+    std::string body = bodyStart == std::string::npos ? "" : request.substr(bodyStart + 4);
+
+    if (request.compare(0, 12, "POST /scores") == 0) {
+        std::istringstream lines(body);
+        Entry entry;
+        int accepted = 0;
+        while (lines >> entry.name >> entry.score) {
+            entries.push_back(entry);
+            accepted++;
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.score > b.score; });
+        std::cout << "Accepted " << accepted << " scores" << std::endl;
+        return "HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n";
+    }
+
+    if (request.compare(0, 8, "GET /top") == 0) {
+        size_t count = 5;
+        size_t parameter = request.find("n=");
+        if (parameter != std::string::npos && parameter < request.find("\r\n")) {
+            count = static_cast<size_t>(std::strtoul(request.c_str() + parameter + 2, nullptr, 10));
+        }
+        std::ostringstream reply;
+        for (size_t i = 0; i < entries.size() && i < count; i++) {
+            reply << entries[i].name << " " << entries[i].score << "\n";
+        }
+        std::string text = reply.str();
+        return "HTTP/1.0 200 OK\r\nContent-Length: " + std::to_string(text.size()) + "\r\n\r\n" + text;
+    }
+
+    return "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+}
+
+int main(int argc, char* args[]) {
+    int port = 8085;
+    int delayMs = 0;
+    bool dead = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = std::atoi(args[++i]);
+        } else if (arg == "--delay-ms" && i + 1 < argc) {
+            delayMs = std::atoi(args[++i]);
+        } else if (arg == "--dead") {
+            dead = true;
+        } else {
+            std::cerr << "Usage: " << args[0] << " [--port N] [--delay-ms N] [--dead]" << std::endl;
+            return 1;
+        }
+    }
+
+    NetSocket::startup();
+    NetSocket listener;
+    if (!listener.listenOn(port)) {
+        std::cerr << "Could not listen on port " << port << std::endl;
+        return 1;
+    }
+    std::cout << "Leaderboard stand-in on 127.0.0.1:" << listener.localPort()
+              << (dead ? " (dead)" : "") << std::endl;
+
+    std::vector<Entry> entries;
+    std::vector<NetSocket> abandoned;  // Connections a dead server keeps open and ignores
+    while (true) {
+        NetSocket client = listener.accept(5000);
+        if (!client.isOpen()) {
+            continue;
+        }
+        if (dead) {
+            abandoned.push_back(std::move(client));
+            continue;
+        }
+
+        std::string request;
+        if (!client.receiveRequest(request, 64 * 1024)) {
+            continue;
+        }
+        if (delayMs > 0) {
+            sleepMs(delayMs);
+        }
+        client.sendAll(respond(request, entries));
+    }
+}
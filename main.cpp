@@ -3,179 +3,524 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <vector>
-#include <random>
 #include <ctime>
 #include <fstream>
 #include <string>
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <cctype>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
 
-// Game constants
-const int SCREEN_WIDTH = 800;
-const int SCREEN_HEIGHT = 400;
-const int GROUND_LEVEL = 300;
-const int PLAYER_WIDTH = 50;
-const int PLAYER_HEIGHT = 80;
-const int OBSTACLE_WIDTH = 30;
-const int OBSTACLE_HEIGHT = 50;
-const int JUMP_VELOCITY = -16;
-const float GRAVITY = 0.8f;
-const int GAME_SPEED_INITIAL = 5;
-const int GAME_SPEED_INCREMENT = 1;
-const int SPEED_UP_SCORE = 500;
-const std::string HIGH_SCORE_FILE = "highscore.dat";
-const std::string FONT_FILE = "arial.ttf"; // Make sure this file exists in your project directory
-
-// Obstacle types
-enum ObstacleType {
-    COFFEE_CUP,
-    BRIEFCASE,
-    FIRE_HYDRANT,
-    TRASH_CAN,
-    CAR,
-    BICYCLE,
-    PUDDLE,
-    DOG,
-    OBSTACLE_TYPE_COUNT
+#include "asset_pack_format.h"
+#include "batch_env.h"
+#include "counter_rng.h"
+#include "course.h"
+#include "course_format.h"
+#include "game_constants.h"
+#include "mapped_file.h"
+#include "net_socket.h"
+#include "shared_memory.h"
+#include "sprite_animations.h"
+#include "state_export_format.h"
+#include "swept_collision.h"
+#include "telemetry_format.h"
+
+// Lock-free single-producer/single-consumer ring buffer.
+// Capacity must be a power of two; one slot is never used so that
+// head == tail always means empty.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+private:
+    T slots[Capacity];
+    alignas(64) std::atomic<size_t> head;  // Next slot to write, owned by the producer
+    alignas(64) std::atomic<size_t> tail;  // Next slot to read, owned by the consumer
+
+public:
+    SpscRing() : head(0), tail(0) {}
+
+    bool push(const T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t next = (h + 1) & (Capacity - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            return false;  // Full
+        }
+        slots[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;  // Empty
+        }
+        item = slots[t];
+        tail.store((t + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    // Pops up to maxItems in one go, touching the shared indices only once
+    size_t popBatch(T* out, size_t maxItems) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (t != h && count < maxItems) {
+            out[count++] = slots[t];
+            t = (t + 1) & (Capacity - 1);
+        }
+        tail.store(t, std::memory_order_release);
+        return count;
+    }
 };
 
-class Player {
+// Read-only view of the asset pack. The whole pack is mapped with one
+// file open and assets are handed to SDL as RWops over the mapping, so
+// nothing is copied on load. The pack must outlive anything opened from it.
+// Without a pack, assets are read from loose files beside the executable.
+class AssetPack {
+private:
+    MappedFile file;
+    const AssetPackEntry* entries;
+    uint32_t entryCount;
+    bool loose;
+
+    // The name field need not be terminated in a damaged pack, so never read past it
+    static std::string entryName(const AssetPackEntry& e) {
+        const void* terminator = std::memchr(e.name, '\0', sizeof(e.name));
+        size_t length = terminator ? static_cast<const char*>(terminator) - e.name : sizeof(e.name);
+        return std::string(e.name, length);
+    }
+
 public:
-    float x, y;
-    float velocity;
-    bool isJumping;
-    SDL_Rect hitbox;
-    bool jumpScored;
-    int animFrame;    // Current animation frame
-    int frameCounter; // Frame counter for animation timing
+    AssetPack() : entries(nullptr), entryCount(0), loose(false) {}
 
-    Player() : x(100), y(GROUND_LEVEL - PLAYER_HEIGHT), 
-              velocity(0), isJumping(false), jumpScored(false),
-              animFrame(0), frameCounter(0) {
-        updateHitbox();
+    void useLooseFiles() {
+        loose = true;
     }
 
-    void update() {
-        // Update animation frame counter
-        frameCounter++;
-        if (frameCounter >= 5) { // Change animation frame every 5 game frames
-            frameCounter = 0;
-            animFrame = (animFrame + 1) % 4; // 4 animation frames (0-3)
+    bool open(const std::string& path) {
+        if (!file.open(path)) {
+            std::cerr << "Could not open asset pack " << path << std::endl;
+            return false;
+        }
+
+        AssetPackHeader header;
+        if (file.size() < sizeof(header)) {
+            std::cerr << path << " is too short to be an asset pack" << std::endl;
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != ASSET_PACK_VERSION) {
+            std::cerr << path << " is not a version " << ASSET_PACK_VERSION << " asset pack" << std::endl;
+            return false;
+        }
+        if (file.size() < sizeof(header) + static_cast<uint64_t>(header.entryCount) * sizeof(AssetPackEntry)) {
+            std::cerr << path << " has a truncated entry table" << std::endl;
+            return false;
         }
 
-        if (isJumping) {
-            velocity += GRAVITY;
-            y += velocity;
+        entries = reinterpret_cast<const AssetPackEntry*>(file.data() + sizeof(header));
+        entryCount = header.entryCount;
+        return true;
+    }
 
-            // Check if player landed
-            if (y >= GROUND_LEVEL - PLAYER_HEIGHT) {
-                y = GROUND_LEVEL - PLAYER_HEIGHT;
-                velocity = 0;
-                isJumping = false;
-                jumpScored = false;
+    // Returns a RWops over the named asset, or nullptr if the pack lacks it
+    SDL_RWops* openAsset(const std::string& name) const {
+        if (loose) {
+            SDL_RWops* data = SDL_RWFromFile(name.c_str(), "rb");
+            if (!data) {
+                std::cerr << "Could not open asset " << name << "! SDL Error: " << SDL_GetError() << std::endl;
             }
+            return data;
         }
-        updateHitbox();
+        const AssetPackEntry* end = entries + entryCount;
+        const AssetPackEntry* entry = std::lower_bound(entries, end, name,
+            [](const AssetPackEntry& e, const std::string& key) { return entryName(e) < key; });
+        if (entry == end || entryName(*entry) != name) {
+            std::cerr << "Asset " << name << " is missing from the asset pack" << std::endl;
+            return nullptr;
+        }
+        // Compared against the space left so a huge offset or size cannot wrap
+        if (entry->offset > file.size() || entry->size > file.size() - entry->offset ||
+            entry->size > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            std::cerr << "Asset " << name << " lies outside the asset pack" << std::endl;
+            return nullptr;
+        }
+        return SDL_RWFromConstMem(file.data() + entry->offset, static_cast<int>(entry->size));
     }
+};
 
-    bool jump() {
-        if (!isJumping) {
-            isJumping = true;
-            velocity = JUMP_VELOCITY;
-            jumpScored = false;
-            return true;
+// A handcrafted course mapped from disk. Seeking consults only the small
+// distance index; records are read where the player is, and the pages
+// behind the player are handed back so resident memory stays flat no
+// matter how long the course is.
+class AuthoredCourse {
+private:
+    MappedFile file;
+    const int64_t* index;
+    const CourseRecord* records;
+    uint64_t recordCount;
+    uint64_t recordOffset;
+    uint32_t indexCount;
+    uint32_t indexStride;
+    uint64_t releasedEnd;  // File offset up to which pages have been handed back
+
+public:
+    AuthoredCourse() : index(nullptr), records(nullptr), recordCount(0), recordOffset(0), indexCount(0), indexStride(0),
+                       releasedEnd(0) {}
+
+    bool open(const std::string& path) {
+        if (!file.open(path)) {
+            std::cerr << "Could not open course " << path << std::endl;
+            return false;
         }
-        return false;
+
+        CourseFileHeader header;
+        if (file.size() < sizeof(header)) {
+            std::cerr << path << " is too short to be a course" << std::endl;
+            file.close();
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, COURSE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != COURSE_FILE_VERSION) {
+            std::cerr << path << " is not a version " << COURSE_FILE_VERSION << " course" << std::endl;
+            file.close();
+            return false;
+        }
+        // Sizes are compared against what is left of the file, so no sum or product can wrap
+        bool consistent = header.indexStride > 0 &&
+            header.indexOffset % sizeof(int64_t) == 0 && header.recordOffset % sizeof(int64_t) == 0 &&
+            header.indexOffset <= file.size() &&
+            header.indexCount <= (file.size() - header.indexOffset) / sizeof(int64_t) &&
+            header.recordOffset <= file.size() &&
+            header.recordCount <= (file.size() - header.recordOffset) / sizeof(CourseRecord) &&
+            header.indexCount == header.recordCount / header.indexStride + (header.recordCount % header.indexStride != 0);
+        if (!consistent) {
+            std::cerr << path << " has a truncated or inconsistent layout" << std::endl;
+            file.close();
+            return false;
+        }
+
+        index = reinterpret_cast<const int64_t*>(file.data() + header.indexOffset);
+        records = reinterpret_cast<const CourseRecord*>(file.data() + header.recordOffset);
+        recordCount = header.recordCount;
+        recordOffset = header.recordOffset;
+        indexCount = header.indexCount;
+        indexStride = header.indexStride;
+        releasedEnd = recordOffset;
+        return true;
     }
 
-    bool canScoreJump() {
-        if (isJumping && !jumpScored && velocity > -2 && velocity < 2) {
-            jumpScored = true;
-            return true;
+    bool isOpen() const {
+        return file.isOpen();
+    }
+
+    uint64_t size() const {
+        return recordCount;
+    }
+
+    const CourseRecord& record(uint64_t i) const {
+        return records[i];
+    }
+
+    // First record at or beyond courseX: a binary search of the index, then
+    // a scan of at most one block. The scan stops at the next block's first
+    // record, which the index already puts at or beyond courseX.
+    uint64_t firstFrom(int64_t courseX) const {
+        uint64_t block = static_cast<uint64_t>(std::lower_bound(index, index + indexCount, courseX) - index);
+        uint64_t i = block == 0 ? 0 : (block - 1) * indexStride;
+        uint64_t end = std::min<uint64_t>(recordCount, block * indexStride);
+        while (i < end && records[i].courseX < courseX) {
+            i++;
         }
-        return false;
+        return i;
     }
 
-    void updateHitbox() {
-        hitbox = {static_cast<int>(x), static_cast<int>(y), PLAYER_WIDTH, PLAYER_HEIGHT};
+    // A run is about to read on from `first`; what it reads again gets released again
+    void restartAt(uint64_t first) {
+        releasedEnd = std::min(releasedEnd, recordOffset + first * sizeof(CourseRecord));
     }
 
-void render(SDL_Renderer* renderer) {
-    // Load PNG image for character texture
-    static SDL_Texture* characterTexture = nullptr;
-    static bool textureLoadAttempted = false;
-    
-    if (characterTexture == nullptr && !textureLoadAttempted) {
-        textureLoadAttempted = true;  // Only try to load once
-        SDL_Surface* surface = IMG_Load("office_worker.png");
-        if (surface) {
-            characterTexture = SDL_CreateTextureFromSurface(renderer, surface);
-            SDL_FreeSurface(surface);
+    // Records before `first` have scrolled past for good. Only what was not
+    // handed back yet is released, so a long run costs the same per block.
+    void releaseBefore(uint64_t first) {
+        uint64_t end = recordOffset + first * sizeof(CourseRecord);
+        if (end > releasedEnd) {
+            releasedEnd = file.discard(static_cast<size_t>(releasedEnd), static_cast<size_t>(end - releasedEnd));
         }
     }
 
-    if (characterTexture) {
-        // Draw the character PNG as the full body
-        SDL_Rect destRect = {static_cast<int>(x), static_cast<int>(y), hitbox.w, hitbox.h};
-        SDL_RenderCopy(renderer, characterTexture, nullptr, &destRect);
-    } else {
-        // Fallback rendering if texture couldn't be loaded
-        // Draw the character
-        SDL_SetRenderDrawColor(renderer, 50, 50, 150, 255); // Blue suit
-        SDL_Rect body = {static_cast<int>(x), static_cast<int>(y), hitbox.w, hitbox.h - 30};
-        SDL_RenderFillRect(renderer, &body);
-        
-        // Head
-        SDL_SetRenderDrawColor(renderer, 255, 213, 170, 255); // Skin tone
-        SDL_Rect head = {static_cast<int>(x + 10), static_cast<int>(y), 30, 30};
-        SDL_RenderFillRect(renderer, &head);
+    uint32_t blockSize() const {
+        return indexStride;
     }
+};
 
-    // Briefcase (if not jumping)
-    if (!isJumping || animFrame % 2 == 0) {
-        SDL_SetRenderDrawColor(renderer, 101, 67, 33, 255); // Brown
-        SDL_Rect briefcase = {static_cast<int>(x + 5), static_cast<int>(y + 60), 20, 15};
-        SDL_RenderFillRect(renderer, &briefcase);
+// Every sprite frame in the game, packed shelf by shelf into one texture
+// so that drawing any frame of anything is a single copy with a source
+// rect. A group of frames is drawn once by its callback at its usual
+// place on a scratch target, and that area is copied into the atlas. The
+// callbacks are kept so the atlas can be baked again after the driver
+// drops render target contents.
+class SpriteAtlas {
+public:
+    static const int SIZE = 1024;
+    typedef std::function<void(SDL_Renderer*, int)> DrawFrame;  // Draws frame n of a group
 
-        // Handle
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_Rect handle = {static_cast<int>(x + 12), static_cast<int>(y + 55), 6, 5};
-        SDL_RenderFillRect(renderer, &handle);
+private:
+    struct Group {
+        SDL_Rect area;  // On the scratch target, in screen coordinates
+        int firstFrame;
+        int frameCount;
+        DrawFrame draw;
+    };
+
+    SDL_Texture* atlas;
+    SDL_Texture* stage;  // Screen-sized scratch target frames are drawn on
+    std::vector<SDL_Rect> frames;
+    std::vector<Group> groups;
+    int shelfX;
+    int shelfY;
+    int shelfHeight;
+
+    bool place(int width, int height, SDL_Rect& rect) {
+        const int padding = 1;
+        if (shelfX + width > SIZE) {
+            shelfX = 0;
+            shelfY += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+        if (width > SIZE || shelfY + height > SIZE) {
+            return false;
+        }
+        rect = {shelfX, shelfY, width, height};
+        shelfX += width + padding;
+        shelfHeight = std::max(shelfHeight, height);
+        return true;
     }
 
-    // Legs - show running animation
-    SDL_SetRenderDrawColor(renderer, 30, 30, 60, 255); // Dark pants
-    if (isJumping) {
-        SDL_Rect leg1 = {static_cast<int>(x + 15), static_cast<int>(y + 60), 8, 20};
-        SDL_Rect leg2 = {static_cast<int>(x + 30), static_cast<int>(y + 60), 8, 15};
-        SDL_RenderFillRect(renderer, &leg1);
-        SDL_RenderFillRect(renderer, &leg2);
-    } else {
-        if (animFrame % 2 == 0) {
-            SDL_Rect leg1 = {static_cast<int>(x + 15), static_cast<int>(y + 50), 8, 30};
-            SDL_Rect leg2 = {static_cast<int>(x + 30), static_cast<int>(y + 60), 8, 20};
-            SDL_RenderFillRect(renderer, &leg1);
-            SDL_RenderFillRect(renderer, &leg2);
+    void bake(SDL_Renderer* renderer, const Group& group) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        // Replace rather than blend, so frames keep straight alpha and are
+        // blended exactly once, when they are drawn on screen
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        for (int i = 0; i < group.frameCount; i++) {
+            SDL_SetRenderTarget(renderer, stage);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+            SDL_RenderFillRect(renderer, &group.area);
+            group.draw(renderer, i);
+            SDL_SetRenderTarget(renderer, atlas);
+            SDL_RenderCopy(renderer, stage, &group.area, &frames[group.firstFrame + i]);
+        }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderTarget(renderer, previousTarget);
+    }
+
+public:
+    SpriteAtlas() : atlas(nullptr), stage(nullptr), shelfX(0), shelfY(0), shelfHeight(0) {}
+
+    bool initialize(SDL_Renderer* renderer) {
+        atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SIZE, SIZE);
+        stage = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                  SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!atlas || !stage) {
+            std::cerr << "Sprite atlas could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureBlendMode(stage, SDL_BLENDMODE_NONE);
+        clearAtlas(renderer);
+        return true;
+    }
+
+    // Bakes frameCount frames of the given screen area; returns the index
+    // of the first, or -1 when the area is off the screen or the atlas is full
+    int addGroup(SDL_Renderer* renderer, SDL_Rect area, int frameCount, DrawFrame draw) {
+        if (!atlas || area.x < 0 || area.y < 0 || area.x + area.w > SCREEN_WIDTH || area.y + area.h > SCREEN_HEIGHT) {
+            return -1;
+        }
+        Group group = {area, static_cast<int>(frames.size()), frameCount, draw};
+        int firstShelfX = shelfX, firstShelfY = shelfY, firstShelfHeight = shelfHeight;
+        for (int i = 0; i < frameCount; i++) {
+            SDL_Rect rect;
+            if (!place(area.w, area.h, rect)) {
+                // Give back the space, so a smaller group can still use it
+                frames.resize(group.firstFrame);
+                shelfX = firstShelfX;
+                shelfY = firstShelfY;
+                shelfHeight = firstShelfHeight;
+                return -1;
+            }
+            frames.push_back(rect);
+        }
+        groups.push_back(group);
+        bake(renderer, groups.back());
+        return group.firstFrame;
+    }
+
+    // Redraws every group into the same places
+    void rebake(SDL_Renderer* renderer) {
+        clearAtlas(renderer);
+        for (const auto& group : groups) {
+            bake(renderer, group);
+        }
+    }
+
+    void clearAtlas(SDL_Renderer* renderer) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, atlas);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderTarget(renderer, previousTarget);
+    }
+
+    SDL_Texture* texture() const {
+        return atlas;
+    }
+
+    const SDL_Rect& frame(int index) const {
+        return frames[index];
+    }
+
+    void clean() {
+        if (atlas) {
+            SDL_DestroyTexture(atlas);
+            atlas = nullptr;
+        }
+        if (stage) {
+            SDL_DestroyTexture(stage);
+            stage = nullptr;
+        }
+        frames.clear();
+        groups.clear();
+        shelfX = shelfY = shelfHeight = 0;
+    }
+
+    ~SpriteAtlas() {
+        clean();
+    }
+};
+
+// How a human runner is drawn. Where it is comes from the RunnerCrowd;
+// what it looks like is one of the player poses baked into the atlas.
+class Player {
+public:
+    float x, y;
+    bool isJumping;
+    SDL_Rect hitbox;
+    const AnimationClip* clip;
+    double clipStartMs;
+    int pose;  // Index into PLAYER_POSES
+
+    Player() : x(PLAYER_X), y(GROUND_LEVEL - PLAYER_HEIGHT), 
+              isJumping(false), clip(&PLAYER_RUN_CLIP), clipStartMs(0.0), pose(PLAYER_RUN_CLIP.firstFrame) {
+        updateHitbox();
+    }
+
+    // Takes the runner's position for this frame and the pose to show at nowMs
+    void follow(float runnerY, bool jumping, double nowMs) {
+        if (jumping != isJumping) {
+            clip = jumping ? &PLAYER_JUMP_CLIP : &PLAYER_RUN_CLIP;
+            clipStartMs = nowMs;
+        }
+        y = runnerY;
+        isJumping = jumping;
+        pose = clipFrame(*clip, nowMs - clipStartMs);
+        updateHitbox();
+    }
+
+    void updateHitbox() {
+        hitbox = {static_cast<int>(x), static_cast<int>(y), PLAYER_WIDTH, PLAYER_HEIGHT};
+    }
+
+    // firstFrame is the atlas frame holding PLAYER_POSES[0], or -1 to draw directly
+    void render(SDL_Renderer* renderer, const SpriteAtlas& atlas, int firstFrame, SDL_Texture* characterTexture) {
+        if (firstFrame < 0) {
+            drawPose(renderer, characterTexture, PLAYER_POSES[pose], hitbox.x, hitbox.y);
+            return;
+        }
+        SDL_RenderCopy(renderer, atlas.texture(), &atlas.frame(firstFrame + pose), &hitbox);
+    }
+
+    // Draws a pose with its top-left at (left, top), for baking into the atlas
+    static void drawPose(SDL_Renderer* renderer, SDL_Texture* characterTexture, const PlayerPose& pose, int left, int top) {
+        if (characterTexture) {
+            // Draw the character PNG as the full body
+            SDL_Rect destRect = {left, top, PLAYER_WIDTH, PLAYER_HEIGHT};
+            SDL_RenderCopy(renderer, characterTexture, nullptr, &destRect);
         } else {
-            SDL_Rect leg1 = {static_cast<int>(x + 15), static_cast<int>(y + 60), 8, 20};
-            SDL_Rect leg2 = {static_cast<int>(x + 30), static_cast<int>(y + 50), 8, 30};
-            SDL_RenderFillRect(renderer, &leg1);
-            SDL_RenderFillRect(renderer, &leg2);
+            // Fallback rendering if texture couldn't be loaded
+            // Draw the character
+            SDL_SetRenderDrawColor(renderer, 50, 50, 150, 255); // Blue suit
+            SDL_Rect body = {left, top, PLAYER_WIDTH, PLAYER_HEIGHT - 30};
+            SDL_RenderFillRect(renderer, &body);
+            
+            // Head
+            SDL_SetRenderDrawColor(renderer, 255, 213, 170, 255); // Skin tone
+            SDL_Rect head = {left + 10, top, 30, 30};
+            SDL_RenderFillRect(renderer, &head);
         }
+
+        if (pose.briefcase) {
+            SDL_SetRenderDrawColor(renderer, 101, 67, 33, 255); // Brown
+            SDL_Rect briefcase = {left + 5, top + 60, 20, 15};
+            SDL_RenderFillRect(renderer, &briefcase);
+
+            // Handle
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_Rect handle = {left + 12, top + 55, 6, 5};
+            SDL_RenderFillRect(renderer, &handle);
+        }
+
+        // Legs
+        SDL_SetRenderDrawColor(renderer, 30, 30, 60, 255); // Dark pants
+        SDL_Rect frontLeg = {left + 15, top + pose.frontLegTop, 8, pose.frontLegLength};
+        SDL_Rect backLeg = {left + 30, top + pose.backLegTop, 8, pose.backLegLength};
+        SDL_RenderFillRect(renderer, &frontLeg);
+        SDL_RenderFillRect(renderer, &backLeg);
     }
-}
 };
 
 
 class Obstacle {
 public:
+    // Room around the hitbox for the parts drawn outside it (caps, handles, steam, ears)
+    static const int SPRITE_MARGIN_X = 10;
+    static const int SPRITE_MARGIN_TOP = 25;
+
     float x;
     int width, height;
     SDL_Rect hitbox;
     ObstacleType type;
+    int firstFrame;  // Sprite atlas frames for this type and size, or -1 to draw directly
 
-    Obstacle(float startX, int w, int h, ObstacleType t) : x(startX), width(w), height(h), type(t) {
+    Obstacle(float startX, int w, int h, ObstacleType t) : x(startX), width(w), height(h), type(t), firstFrame(-1) {
         updateHitbox();
     }
 
+    // Screen area an obstacle with its left edge at `left` covers, decorations included
+    static SDL_Rect spriteArea(int left, int width, int height) {
+        int top = std::max(0, GROUND_LEVEL - height - SPRITE_MARGIN_TOP);
+        SDL_Rect area = {left - SPRITE_MARGIN_X, top, width + 2 * SPRITE_MARGIN_X, GROUND_LEVEL - top};
+        return area;
+    }
+
+    static const AnimationClip& clipFor(ObstacleType type) {
+        return OBSTACLE_CLIPS[type < OBSTACLE_TYPE_COUNT ? type : 0];
+    }
+
     void update(int gameSpeed) {
         x -= gameSpeed;
         updateHitbox();
@@ -189,31 +534,46 @@ public:
         return x + width < 0;
     }
 
-    void render(SDL_Renderer* renderer) {
+    // One copy from the atlas when the obstacle has sprite frames. Each
+    // frame is baked with and without decorations, the small details
+    // (steam, clasps, chains, hubcaps...) the quality scaler drops first.
+    void render(SDL_Renderer* renderer, const SpriteAtlas& atlas, bool decorations, double nowMs) {
+        int frame = clipFrame(clipFor(type), nowMs);
+        if (firstFrame < 0) {
+            draw(renderer, decorations, frame);
+            return;
+        }
+        SDL_Rect destination = spriteArea(hitbox.x, width, height);
+        SDL_RenderCopy(renderer, atlas.texture(), &atlas.frame(firstFrame + frame * 2 + (decorations ? 1 : 0)),
+                       &destination);
+    }
+
+    // Draws the obstacle shape by shape; how its sprite frames are baked
+    void draw(SDL_Renderer* renderer, bool decorations, int frame) {
         switch (type) {
             case COFFEE_CUP:
-                renderCoffeeCup(renderer);
+                renderCoffeeCup(renderer, decorations, frame);
                 break;
             case BRIEFCASE:
-                renderBriefcase(renderer);
+                renderBriefcase(renderer, decorations);
                 break;
             case FIRE_HYDRANT:
-                renderFireHydrant(renderer);
+                renderFireHydrant(renderer, decorations);
                 break;
             case TRASH_CAN:
-                renderTrashCan(renderer);
+                renderTrashCan(renderer, decorations);
                 break;
             case CAR:
-                renderCar(renderer);
+                renderCar(renderer, decorations);
                 break;
             case BICYCLE:
                 renderBicycle(renderer);
                 break;
             case PUDDLE:
-                renderPuddle(renderer);
+                renderPuddle(renderer, decorations);
                 break;
             case DOG:
-                renderDog(renderer);
+                renderDog(renderer, frame);
                 break;
             default:
                 // Default obstacle
@@ -224,7 +584,7 @@ public:
     }
 
 private:
-    void renderCoffeeCup(SDL_Renderer* renderer) {
+    void renderCoffeeCup(SDL_Renderer* renderer, bool decorations, int frame) {
         // Draw coffee cup
         SDL_SetRenderDrawColor(renderer, 139, 69, 19, 255); // Brown
         SDL_RenderFillRect(renderer, &hitbox);
@@ -238,15 +598,17 @@ private:
         SDL_Rect coffee = {static_cast<int>(x + 5), GROUND_LEVEL - height + 5, width - 10, 10};
         SDL_RenderFillRect(renderer, &coffee);
         
-        // Steam
-        SDL_SetRenderDrawColor(renderer, 220, 220, 220, 150); // Light gray
-        for (int i = 0; i < 3; i++) {
-            SDL_Rect steam = {static_cast<int>(x + 10 + i * 7), GROUND_LEVEL - height - 5 - (i % 2) * 5, 3, 5};
-            SDL_RenderFillRect(renderer, &steam);
+        // Steam, its puffs trading places every frame
+        if (decorations) {
+            SDL_SetRenderDrawColor(renderer, 220, 220, 220, 150); // Light gray
+            for (int i = 0; i < 3; i++) {
+                SDL_Rect steam = {static_cast<int>(x + 10 + i * 7), GROUND_LEVEL - height - 5 - ((i + frame) % 2) * 5, 3, 5};
+                SDL_RenderFillRect(renderer, &steam);
+            }
         }
     }
     
-    void renderBriefcase(SDL_Renderer* renderer) {
+    void renderBriefcase(SDL_Renderer* renderer, bool decorations) {
         // Main briefcase body
         SDL_SetRenderDrawColor(renderer, 80, 40, 20, 255); // Dark brown
         SDL_RenderFillRect(renderer, &hitbox);
@@ -257,14 +619,16 @@ private:
         SDL_RenderFillRect(renderer, &handle);
         
         // Clasps
-        SDL_SetRenderDrawColor(renderer, 200, 180, 0, 255); // Gold
-        SDL_Rect clasp1 = {static_cast<int>(x + width/4), GROUND_LEVEL - height/2, 5, 5};
-        SDL_Rect clasp2 = {static_cast<int>(x + width*3/4 - 5), GROUND_LEVEL - height/2, 5, 5};
-        SDL_RenderFillRect(renderer, &clasp1);
-        SDL_RenderFillRect(renderer, &clasp2);
+        if (decorations) {
+            SDL_SetRenderDrawColor(renderer, 200, 180, 0, 255); // Gold
+            SDL_Rect clasp1 = {static_cast<int>(x + width/4), GROUND_LEVEL - height/2, 5, 5};
+            SDL_Rect clasp2 = {static_cast<int>(x + width*3/4 - 5), GROUND_LEVEL - height/2, 5, 5};
+            SDL_RenderFillRect(renderer, &clasp1);
+            SDL_RenderFillRect(renderer, &clasp2);
+        }
     }
     
-    void renderFireHydrant(SDL_Renderer* renderer) {
+    void renderFireHydrant(SDL_Renderer* renderer, bool decorations) {
         // Main body
         SDL_SetRenderDrawColor(renderer, 220, 30, 30, 255); // Red
         SDL_RenderFillRect(renderer, &hitbox);
@@ -282,14 +646,16 @@ private:
         SDL_RenderFillRect(renderer, &outlet2);
         
         // Chain
-        SDL_SetRenderDrawColor(renderer, 70, 70, 70, 255); // Gray
-        for (int i = 0; i < 3; i++) {
-            SDL_Rect chain = {static_cast<int>(x + width/2 - 2), GROUND_LEVEL - height + 5 + i*8, 4, 4};
-            SDL_RenderFillRect(renderer, &chain);
+        if (decorations) {
+            SDL_SetRenderDrawColor(renderer, 70, 70, 70, 255); // Gray
+            for (int i = 0; i < 3; i++) {
+                SDL_Rect chain = {static_cast<int>(x + width/2 - 2), GROUND_LEVEL - height + 5 + i*8, 4, 4};
+                SDL_RenderFillRect(renderer, &chain);
+            }
         }
     }
     
-    void renderTrashCan(SDL_Renderer* renderer) {
+    void renderTrashCan(SDL_Renderer* renderer, bool decorations) {
         // Main body
         SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255); // Gray
         SDL_RenderFillRect(renderer, &hitbox);
@@ -300,16 +666,18 @@ private:
         SDL_RenderFillRect(renderer, &lid);
         
         // Trash pattern
-        SDL_SetRenderDrawColor(renderer, 50, 150, 50, 255); // Green
-        SDL_Rect trash1 = {static_cast<int>(x + 5), GROUND_LEVEL - height + 15, 5, 10};
-        SDL_RenderFillRect(renderer, &trash1);
-        
-        SDL_SetRenderDrawColor(renderer, 200, 200, 100, 255); // Yellow-ish
-        SDL_Rect trash2 = {static_cast<int>(x + width - 10), GROUND_LEVEL - height + 20, 8, 5};
-        SDL_RenderFillRect(renderer, &trash2);
+        if (decorations) {
+            SDL_SetRenderDrawColor(renderer, 50, 150, 50, 255); // Green
+            SDL_Rect trash1 = {static_cast<int>(x + 5), GROUND_LEVEL - height + 15, 5, 10};
+            SDL_RenderFillRect(renderer, &trash1);
+            
+            SDL_SetRenderDrawColor(renderer, 200, 200, 100, 255); // Yellow-ish
+            SDL_Rect trash2 = {static_cast<int>(x + width - 10), GROUND_LEVEL - height + 20, 8, 5};
+            SDL_RenderFillRect(renderer, &trash2);
+        }
     }
     
-    void renderCar(SDL_Renderer* renderer) {
+    void renderCar(SDL_Renderer* renderer, bool decorations) {
         // Car body
         SDL_SetRenderDrawColor(renderer, 30, 100, 180, 255); // Blue car
         SDL_RenderFillRect(renderer, &hitbox);
@@ -326,17 +694,19 @@ private:
         SDL_RenderFillRect(renderer, &wheel1);
         SDL_RenderFillRect(renderer, &wheel2);
         
-        // Hubcaps
-        SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255); // Silver
-        SDL_Rect hub1 = {static_cast<int>(x + width/5 + 5), GROUND_LEVEL - 10, 5, 5};
-        SDL_Rect hub2 = {static_cast<int>(x + width - width/3 + 5), GROUND_LEVEL - 10, 5, 5};
-        SDL_RenderFillRect(renderer, &hub1);
-        SDL_RenderFillRect(renderer, &hub2);
-        
-        // Headlights
-        SDL_SetRenderDrawColor(renderer, 255, 255, 200, 255); // Yellow-white
-        SDL_Rect headlight = {static_cast<int>(x + width - 8), GROUND_LEVEL - height + height/2, 8, 8};
-        SDL_RenderFillRect(renderer, &headlight);
+        if (decorations) {
+            // Hubcaps
+            SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255); // Silver
+            SDL_Rect hub1 = {static_cast<int>(x + width/5 + 5), GROUND_LEVEL - 10, 5, 5};
+            SDL_Rect hub2 = {static_cast<int>(x + width - width/3 + 5), GROUND_LEVEL - 10, 5, 5};
+            SDL_RenderFillRect(renderer, &hub1);
+            SDL_RenderFillRect(renderer, &hub2);
+            
+            // Headlights
+            SDL_SetRenderDrawColor(renderer, 255, 255, 200, 255); // Yellow-white
+            SDL_Rect headlight = {static_cast<int>(x + width - 8), GROUND_LEVEL - height + height/2, 8, 8};
+            SDL_RenderFillRect(renderer, &headlight);
+        }
     }
     
     void renderBicycle(SDL_Renderer* renderer) {
@@ -377,21 +747,23 @@ private:
         SDL_RenderFillRect(renderer, &handlebar);
     }
     
-    void renderPuddle(SDL_Renderer* renderer) {
+    void renderPuddle(SDL_Renderer* renderer, bool decorations) {
         // Puddle base
         SDL_SetRenderDrawColor(renderer, 50, 100, 180, 150); // Semi-transparent blue
         SDL_Rect puddle = {static_cast<int>(x), GROUND_LEVEL - 5, width, 5};
         SDL_RenderFillRect(renderer, &puddle);
         
         // Reflection
-        SDL_SetRenderDrawColor(renderer, 150, 200, 255, 100); // Lighter blue
-        for (int i = 0; i < 3; i++) {
-            SDL_Rect reflection = {static_cast<int>(x + 5 + i*15), GROUND_LEVEL - 4, 10, 2};
-            SDL_RenderFillRect(renderer, &reflection);
+        if (decorations) {
+            SDL_SetRenderDrawColor(renderer, 150, 200, 255, 100); // Lighter blue
+            for (int i = 0; i < 3; i++) {
+                SDL_Rect reflection = {static_cast<int>(x + 5 + i*15), GROUND_LEVEL - 4, 10, 2};
+                SDL_RenderFillRect(renderer, &reflection);
+            }
         }
     }
     
-    void renderDog(SDL_Renderer* renderer) {
+    void renderDog(SDL_Renderer* renderer, int frame) {
         // Body
         SDL_SetRenderDrawColor(renderer, 150, 120, 60, 255); // Brown
         SDL_RenderFillRect(renderer, &hitbox);
@@ -414,27 +786,332 @@ private:
         SDL_Rect tail = {static_cast<int>(x), GROUND_LEVEL - height - 5, 15, 5};
         SDL_RenderFillRect(renderer, &tail);
         
-        // Legs
+        // Legs, drawn together on every other frame of the trot
         for (int i = 0; i < 2; i++) {
-            SDL_Rect leg = {static_cast<int>(x + 10 + i*(width-20)), GROUND_LEVEL - 15, 8, 15};
+            int stride = frame % 2 == 0 ? 0 : (i == 0 ? 4 : -4);
+            SDL_Rect leg = {static_cast<int>(x + 10 + i*(width-20)) + stride, GROUND_LEVEL - 15, 8, 15};
             SDL_RenderFillRect(renderer, &leg);
         }
     }
 };
 
+// Who decides when a runner jumps
+enum RunnerControl : uint8_t {
+    RUNNER_HUMAN,  // A key on the keyboard
+    RUNNER_GHOST,  // Retraces the previous run; never collides or scores
+    RUNNER_BOT     // Jumps once the next obstacle is within its reach
+};
+
+// What happened to a runner during the last frame, as bits
+enum RunnerEvent : uint8_t {
+    RUNNER_LANDED = 1,
+    RUNNER_SCORED = 2,
+    RUNNER_CRASHED = 4
+};
+
+// Every runner of a run, kept in parallel arrays and updated in one pass
+// so a crowd of bots costs little more than the player alone. All runners
+// stand at PLAYER_X and share one obstacle field: whether an obstacle
+// crosses that column this frame is worked out once per obstacle, and
+// only then does each runner test its own vertical sweep against it.
+// Humans come first, then the ghost, then bots; runner 0 is the player.
+class RunnerCrowd {
+public:
+    static const int MAX_RUNNERS = 1024;
+
+    // Where the player was at one point of a run, for the next run's ghost
+    struct GhostSample {
+        int64_t distance;  // Course distance at the start of the frame
+        float y;
+        bool jumping;
+    };
+
+private:
+    std::vector<float> y;         // Top of the hitbox
+    std::vector<float> startY;    // Where this frame's move began
+    std::vector<float> velocity;
+    std::vector<float> reach;     // Bots: frames before an obstacle arrives that they jump
+    std::vector<uint32_t> score;
+    std::vector<uint8_t> control;
+    std::vector<uint8_t> jumping;
+    std::vector<uint8_t> jumpScored;
+    std::vector<uint8_t> running;  // Not crashed yet
+    std::vector<uint8_t> events;
+    std::vector<SDL_Color> tint;
+    std::vector<float> phaseMs;   // Where each runner's animation stands relative to the clock
+    std::vector<GhostSample> ghostTrace;
+    size_t ghostCursor;
+    int humans;
+    int humansRunning;
+    uint32_t leadingScore;
+    std::vector<SDL_Vertex> vertices;  // Crowd geometry, rebuilt every frame
+    std::vector<int> indices;
+
+    void startJump(int runner) {
+        jumping[runner] = 1;
+        velocity[runner] = JUMP_VELOCITY;
+        jumpScored[runner] = 0;
+    }
+
+    // Frames until the nearest obstacle ahead reaches the runners' column
+    static float framesToNextObstacle(const std::vector<Obstacle>& obstacles, int gameSpeed) {
+        // Obstacles are kept in course order, so the first one ahead is the nearest
+        for (const auto& obstacle : obstacles) {
+            float gap = obstacle.x - (PLAYER_X + PLAYER_WIDTH);
+            if (gap >= 0.0f) {
+                return gap / gameSpeed;
+            }
+        }
+        return std::numeric_limits<float>::infinity();
+    }
+
+public:
+    RunnerCrowd() : ghostCursor(0), humans(0), humansRunning(0), leadingScore(0) {}
+
+    // Lines up a new run. A ghost joins when there is a trace to follow;
+    // bot reflexes are drawn from the seed so a seeded run is repeatable.
+    void reset(int humanCount, const std::vector<GhostSample>& ghost, int botCount, uint64_t seed) {
+        humans = std::max(1, std::min(humanCount, MAX_RUNNERS));
+        int ghosts = ghost.empty() ? 0 : 1;
+        int count = std::min(humans + ghosts + std::max(0, botCount), MAX_RUNNERS);
+        
+        y.assign(count, static_cast<float>(GROUND_LEVEL - PLAYER_HEIGHT));
+        startY = y;
+        velocity.assign(count, 0.0f);
+        reach.assign(count, 0.0f);
+        score.assign(count, 0);
+        control.assign(count, RUNNER_BOT);
+        jumping.assign(count, 0);
+        jumpScored.assign(count, 0);
+        running.assign(count, 1);
+        events.assign(count, 0);
+        tint.assign(count, SDL_Color{255, 255, 255, 255});
+        phaseMs.assign(count, 0.0f);
+        
+        CounterRng random(seed, RNG_STREAM_BOTS);
+        for (int i = 0; i < count; i++) {
+            if (i < humans) {
+                control[i] = RUNNER_HUMAN;
+            } else if (i < humans + ghosts) {
+                control[i] = RUNNER_GHOST;
+                tint[i] = {255, 255, 255, 110};
+            } else {
+                reach[i] = static_cast<float>(random.range(i, 0, 3, 30));
+                tint[i] = {static_cast<Uint8>(random.range(i, 1, 80, 255)), static_cast<Uint8>(random.range(i, 2, 80, 255)),
+                           static_cast<Uint8>(random.range(i, 3, 80, 255)), 150};
+                phaseMs[i] = static_cast<float>(random.range(i, 4, 0, 999));
+            }
+        }
+        ghostTrace = ghost;
+        ghostCursor = 0;
+        humansRunning = humans;
+        leadingScore = 0;
+    }
+
+    // A human's jump key; false while in the air or out of the run
+    bool jump(int runner) {
+        if (runner >= humans || !running[runner] || jumping[runner]) {
+            return false;
+        }
+        startJump(runner);
+        return true;
+    }
+
+    // Input, physics and scoring for every runner still in, before the
+    // obstacles move. distance is the course distance at the frame start.
+    void step(const std::vector<Obstacle>& obstacles, int64_t distance, int gameSpeed) {
+        float framesAway = framesToNextObstacle(obstacles, gameSpeed);
+        int count = size();
+        for (int i = 0; i < count; i++) {
+            events[i] = 0;
+            startY[i] = y[i];
+            if (!running[i]) {
+                continue;
+            }
+            
+            // The ghost is placed by course distance rather than simulated, so it
+            // keeps its line over the same obstacles whatever the speed is now
+            if (control[i] == RUNNER_GHOST) {
+                while (ghostCursor + 1 < ghostTrace.size() && ghostTrace[ghostCursor + 1].distance <= distance) {
+                    ghostCursor++;
+                }
+                const GhostSample& sample = ghostTrace[ghostCursor];
+                y[i] = sample.y;
+                jumping[i] = sample.jumping;
+                if (distance > ghostTrace.back().distance) {
+                    running[i] = 0;  // Past where the recorded run ended
+                }
+                continue;
+            }
+            
+            if (!jumping[i] && control[i] == RUNNER_BOT && framesAway <= reach[i]) {
+                startJump(i);
+            }
+            
+            if (jumping[i]) {
+                velocity[i] += GRAVITY;
+                y[i] += velocity[i];
+                if (y[i] >= GROUND_LEVEL - PLAYER_HEIGHT) {
+                    y[i] = GROUND_LEVEL - PLAYER_HEIGHT;
+                    velocity[i] = 0.0f;
+                    jumping[i] = 0;
+                    jumpScored[i] = 0;
+                    events[i] |= RUNNER_LANDED;
+                }
+            }
+            
+            // A jump scores once, around the top of its arc
+            if (jumping[i] && !jumpScored[i] && velocity[i] > -2 && velocity[i] < 2) {
+                jumpScored[i] = 1;
+                score[i] += JUMP_SCORE;
+                events[i] |= RUNNER_SCORED;
+                leadingScore = std::max(leadingScore, score[i]);
+            }
+        }
+    }
+
+    // Tests the runners still in against one obstacle as it moves from
+    // leftStart to leftEnd this frame. Runners it hits are put back where
+    // they touched it and drop out. Returns the earliest time of impact
+    // among the humans it hit, or -1 if it hit none.
+    float sweep(int leftStart, int leftEnd, int width, int height) {
+        float enterX, exitX;
+        sweptColumnInterval(leftStart, leftEnd, width, enterX, exitX);
+        if (std::max(enterX, 0.0f) >= std::min(exitX, 1.0f)) {
+            return -1.0f;  // Nowhere near the runners this frame, the usual case
+        }
+        
+        float humanImpact = -1.0f;
+        int count = size();
+        for (int i = 0; i < count; i++) {
+            float impact;
+            if (!running[i] || control[i] == RUNNER_GHOST ||
+                !sweptRunnerHit(static_cast<int>(startY[i]), static_cast<int>(y[i]), height, enterX, exitX, impact)) {
+                continue;
+            }
+            y[i] = startY[i] + (y[i] - startY[i]) * impact;
+            running[i] = 0;
+            events[i] |= RUNNER_CRASHED;
+            if (control[i] == RUNNER_HUMAN) {
+                humansRunning--;
+                if (humanImpact < 0.0f || impact < humanImpact) {
+                    humanImpact = impact;
+                }
+            }
+        }
+        return humanImpact;
+    }
+
+    // Draws the ghost and bots still in with one textured geometry call,
+    // each in its current pose from the atlas frames starting at firstFrame.
+    // Without atlas frames (-1) they are drawn as tinted silhouettes.
+    void render(SDL_Renderer* renderer, const SpriteAtlas& atlas, int firstFrame, double nowMs) {
+        // Sized once for everyone and filled in place; the buffers keep their capacity
+        vertices.resize(y.size() * 4);
+        indices.resize(y.size() * 6);
+        const float x0 = PLAYER_X;
+        const float x1 = PLAYER_X + PLAYER_WIDTH;
+        const float texel = 1.0f / SpriteAtlas::SIZE;
+        const bool baked = firstFrame >= 0;
+        const SDL_Rect unbaked = {0, 0, 0, 0};
+        int quads = 0;
+        for (int i = humans; i < size(); i++) {
+            if (!running[i]) {
+                continue;
+            }
+            const AnimationClip& clip = jumping[i] ? PLAYER_JUMP_CLIP : PLAYER_RUN_CLIP;
+            const SDL_Rect& source = baked ? atlas.frame(firstFrame + clipFrame(clip, nowMs + phaseMs[i])) : unbaked;
+            float u0 = source.x * texel;
+            float u1 = (source.x + source.w) * texel;
+            float v0 = source.y * texel;
+            float v1 = (source.y + source.h) * texel;
+            
+            float y0 = static_cast<float>(static_cast<int>(y[i]));
+            float y1 = y0 + PLAYER_HEIGHT;
+            SDL_Vertex* quad = &vertices[quads * 4];
+            quad[0] = {{x0, y0}, tint[i], {u0, v0}};
+            quad[1] = {{x1, y0}, tint[i], {u1, v0}};
+            quad[2] = {{x1, y1}, tint[i], {u1, v1}};
+            quad[3] = {{x0, y1}, tint[i], {u0, v1}};
+            int base = quads * 4;
+            int* corner = &indices[quads * 6];
+            corner[0] = base;
+            corner[1] = base + 1;
+            corner[2] = base + 2;
+            corner[3] = base;
+            corner[4] = base + 2;
+            corner[5] = base + 3;
+            quads++;
+        }
+        if (quads > 0) {
+            SDL_RenderGeometry(renderer, baked ? atlas.texture() : nullptr, vertices.data(), quads * 4, indices.data(), quads * 6);
+        }
+    }
+
+    int size() const {
+        return static_cast<int>(y.size());
+    }
+
+    int humanCount() const {
+        return humans;
+    }
+
+    int humansLeft() const {
+        return humansRunning;
+    }
+
+    // Best score any runner has reached this run; the shared speed follows it
+    uint32_t leading() const {
+        return leadingScore;
+    }
+
+    float runnerY(int runner) const {
+        return y[runner];
+    }
+
+    float runnerVelocity(int runner) const {
+        return velocity[runner];
+    }
+
+    bool isJumping(int runner) const {
+        return jumping[runner] != 0;
+    }
+
+    bool isRunning(int runner) const {
+        return running[runner] != 0;
+    }
+
+    uint8_t eventsOf(int runner) const {
+        return events[runner];
+    }
+
+    uint32_t scoreOf(int runner) const {
+        return score[runner];
+    }
+};
+
+const int RunnerCrowd::MAX_RUNNERS;  // Bound by reference in std::min
+
 class ScoreManager {
 private:
     unsigned int currentScore;
     unsigned int highScore;
+    bool persistent;
     
 public:
-    ScoreManager() : currentScore(0), highScore(0) {
+    ScoreManager() : currentScore(0), highScore(0), persistent(true) {
         loadHighScore();
     }
     
+    // Forget the stored high score and never write one, for reproducible runs
+    void disablePersistence() {
+        persistent = false;
+        highScore = 0;
+    }
+    
     void incrementJumpScore() {
         // Increment score specifically for jumps
-        currentScore += 10; // Jumps give 10 points
+        currentScore += JUMP_SCORE;
         
         if (currentScore > highScore) {
             highScore = currentScore;
@@ -464,6 +1141,9 @@ public:
     }
     
     void saveHighScore() {
+        if (!persistent) {
+            return;
+        }
         std::ofstream file(HIGH_SCORE_FILE);
         if (file.is_open()) {
             file << highScore;
@@ -476,329 +1156,1592 @@ public:
     }
 };
 
-class TextManager {
+class TelemetryWriter {
 private:
-    TTF_Font* font;
+    static const size_t RING_CAPACITY = 4096;
+    static const size_t WRITE_BATCH = 256;
+
+    SpscRing<TelemetryRecord, RING_CAPACITY> ring;
+    std::FILE* file;
+    SDL_Thread* thread;
+    std::atomic<bool> running;
+    std::atomic<uint32_t> droppedCount;
+    uint64_t recordCount;  // Only touched by the writer thread
+
+    static int writerThread(void* data) {
+        TelemetryWriter* self = static_cast<TelemetryWriter*>(data);
+        TelemetryRecord batch[WRITE_BATCH];
+
+        while (true) {
+            // Read the flag before draining so nothing pushed before stop() is lost
+            bool keepRunning = self->running.load(std::memory_order_acquire);
+            size_t count = self->ring.popBatch(batch, WRITE_BATCH);
+            if (count > 0) {
+                std::fwrite(batch, sizeof(TelemetryRecord), count, self->file);
+                self->recordCount += count;
+            } else if (!keepRunning) {
+                break;
+            } else {
+                SDL_Delay(5);  // Events are sparse, no need to spin
+            }
+        }
+        return 0;
+    }
+
+public:
+    TelemetryWriter() : file(nullptr), thread(nullptr), running(false), droppedCount(0), recordCount(0) {}
+
+    bool start(const std::string& path) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Could not open telemetry log " << path << std::endl;
+            return false;
+        }
+
+        TelemetryHeader header = {};
+        std::copy(TELEMETRY_MAGIC, TELEMETRY_MAGIC + 4, header.magic);
+        header.version = TELEMETRY_VERSION;
+        header.recordSize = sizeof(TelemetryRecord);
+        header.startUnixTime = static_cast<uint64_t>(time(nullptr));
+        std::fwrite(&header, sizeof(header), 1, file);
+
+        running.store(true, std::memory_order_release);
+        thread = SDL_CreateThread(writerThread, "TelemetryWriter", this);
+        if (!thread) {
+            std::cerr << "Could not start telemetry thread! SDL Error: " << SDL_GetError() << std::endl;
+            running.store(false);
+            std::fclose(file);
+            file = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    // Called from the game thread; never blocks
+    void record(TelemetryEventKind kind, int arg1 = 0, int arg2 = 0, int obstacleType = -1) {
+        if (!thread) {
+            return;
+        }
+        TelemetryRecord event;
+        event.timeMs = SDL_GetTicks();
+        event.kind = kind;
+        event.obstacleType = obstacleType < 0 ? 0xFF : static_cast<uint8_t>(obstacleType);
+        event.reserved = 0;
+        event.arg1 = arg1;
+        event.arg2 = arg2;
+        if (!ring.push(event)) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void stop() {
+        if (thread) {
+            running.store(false, std::memory_order_release);
+            SDL_WaitThread(thread, nullptr);
+            thread = nullptr;
+        }
+        if (file) {
+            // Patch the totals into the header now that they are known
+            uint32_t dropped = droppedCount.load();
+            std::fseek(file, offsetof(TelemetryHeader, recordCount), SEEK_SET);
+            std::fwrite(&recordCount, sizeof(recordCount), 1, file);
+            std::fwrite(&dropped, sizeof(dropped), 1, file);
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+
+    ~TelemetryWriter() {
+        stop();
+    }
+};
+
+// Publishes a snapshot of the game into shared memory every frame for
+// overlays, bots and analysis tools. See state_export_format.h for the
+// layout and the reader side; writing is plain stores and no syscalls.
+class StateExporter {
+private:
+    SharedMemory memory;
+    StateExportRegion* region;
+    StateExportSlot* current;
+    uint64_t frame;
+
+public:
+    StateExporter() : region(nullptr), current(nullptr), frame(0) {}
+
+    bool start() {
+        if (!memory.create(STATE_EXPORT_NAME, sizeof(StateExportRegion))) {
+            std::cerr << "Could not create shared memory " << STATE_EXPORT_NAME << std::endl;
+            return false;
+        }
+        // A session that crashed may have left its region behind; start clean
+        std::memset(memory.data(), 0, sizeof(StateExportRegion));
+        region = reinterpret_cast<StateExportRegion*>(memory.data());
+        std::memcpy(region->header.magic, STATE_EXPORT_MAGIC, sizeof(region->header.magic));
+        region->header.version = STATE_EXPORT_VERSION;
+        region->header.slotCount = STATE_EXPORT_SLOTS;
+        region->header.slotSize = sizeof(StateExportSlot);
+        return true;
+    }
+
+    bool isActive() const {
+        return region != nullptr;
+    }
+
+    // Opens the next ring slot for writing; finish with endFrame()
+    StateExportSnapshot& beginFrame() {
+        current = &region->slots[++frame % STATE_EXPORT_SLOTS];
+        current->sequence.store(current->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);  // Odd sequence lands before any data
+        current->snapshot.frame = frame;
+        return current->snapshot;
+    }
+
+    void endFrame() {
+        current->sequence.store(current->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        region->header.latestFrame.store(frame, std::memory_order_release);
+    }
+
+    void stop() {
+        region = nullptr;
+        current = nullptr;
+        memory.close();
+    }
+
+    ~StateExporter() {
+        stop();
+    }
+};
+
+enum SoundEffect {
+    SOUND_JUMP,
+    SOUND_LAND,
+    SOUND_SCORE,
+    SOUND_SPEED_UP,
+    SOUND_GAME_OVER,
+    SOUND_EFFECT_COUNT
+};
+
+// Sound effects are synthesized into PCM once at startup and mixed in the
+// SDL audio callback. The game thread only posts commands through a
+// lock-free queue, and the callback never allocates or locks.
+class AudioMixer {
+private:
+    static const int MAX_VOICES = 16;
+    static const int MIX_CHUNK = 1024;
+
+    struct Voice {
+        const Sint16* samples;  // nullptr when the voice is free
+        int length;
+        int position;
+    };
+
+    struct AudioCommand {
+        uint8_t sound;
+    };
+
+    SDL_AudioDeviceID device;
+    int sampleRate;
+    std::vector<Sint16> sounds[SOUND_EFFECT_COUNT];
+    Voice voices[MAX_VOICES];  // Only touched by the audio thread once the device runs
+    SpscRing<AudioCommand, 64> commands;
+    unsigned int posted[SOUND_EFFECT_COUNT];  // Game thread only
+    std::atomic<unsigned int> started;        // Voices the audio thread has started
+
+    void startVoice(const std::vector<Sint16>& sound) {
+        // Take a free voice, or steal the one closest to finishing
+        Voice* target = &voices[0];
+        for (auto& voice : voices) {
+            if (!voice.samples) {
+                target = &voice;
+                break;
+            }
+            if (voice.length - voice.position < target->length - target->position) {
+                target = &voice;
+            }
+        }
+        target->samples = sound.data();
+        target->length = static_cast<int>(sound.size());
+        target->position = 0;
+        started.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void mix(Sint16* out, int sampleCount) {
+        AudioCommand command;
+        while (commands.pop(command)) {
+            startVoice(sounds[command.sound]);
+        }
+
+        int accumulator[MIX_CHUNK];
+        while (sampleCount > 0) {
+            int chunk = std::min(sampleCount, MIX_CHUNK);
+            std::fill(accumulator, accumulator + chunk, 0);
+
+            for (auto& voice : voices) {
+                if (!voice.samples) {
+                    continue;
+                }
+                int count = std::min(chunk, voice.length - voice.position);
+                const Sint16* source = voice.samples + voice.position;
+                for (int i = 0; i < count; i++) {
+                    accumulator[i] += source[i];
+                }
+                voice.position += count;
+                if (voice.position >= voice.length) {
+                    voice.samples = nullptr;
+                }
+            }
+
+            for (int i = 0; i < chunk; i++) {
+                out[i] = static_cast<Sint16>(std::max(-32768, std::min(32767, accumulator[i])));
+            }
+            out += chunk;
+            sampleCount -= chunk;
+        }
+    }
+
+    static void SDLCALL audioCallback(void* userdata, Uint8* stream, int len) {
+        static_cast<AudioMixer*>(userdata)->mix(reinterpret_cast<Sint16*>(stream), len / static_cast<int>(sizeof(Sint16)));
+    }
+
+    // Appends a tone sliding from startHz to endHz with a linear fade-out
+    void addTone(std::vector<Sint16>& sound, float startHz, float endHz, float seconds, float volume, bool square = false) {
+        int count = static_cast<int>(seconds * sampleRate);
+        float phase = 0.0f;
+        for (int i = 0; i < count; i++) {
+            float t = static_cast<float>(i) / count;
+            phase += 2.0f * static_cast<float>(M_PI) * (startHz + (endHz - startHz) * t) / sampleRate;
+            float wave = square ? (std::sin(phase) >= 0.0f ? 1.0f : -1.0f) : std::sin(phase);
+            sound.push_back(static_cast<Sint16>(wave * volume * (1.0f - t) * 32767.0f));
+        }
+    }
+
+    void addNoise(std::vector<Sint16>& sound, float seconds, float volume) {
+        int count = static_cast<int>(seconds * sampleRate);
+        float smoothed = 0.0f;
+        for (int i = 0; i < count; i++) {
+            float t = static_cast<float>(i) / count;
+            float white = static_cast<float>(squares32(i, 0x9E3779B97F4A7C15ull)) / 2147483648.0f - 1.0f;
+            smoothed += 0.2f * (white - smoothed);  // Low-pass for a dull thud
+            sound.push_back(static_cast<Sint16>(smoothed * volume * (1.0f - t) * (1.0f - t) * 32767.0f));
+        }
+    }
+
+    void synthesizeSounds() {
+        addTone(sounds[SOUND_JUMP], 300.0f, 650.0f, 0.12f, 0.25f, true);
+        addNoise(sounds[SOUND_LAND], 0.08f, 0.6f);
+        addTone(sounds[SOUND_SCORE], 880.0f, 880.0f, 0.07f, 0.3f);
+        addTone(sounds[SOUND_SCORE], 1320.0f, 1320.0f, 0.12f, 0.3f);
+        addTone(sounds[SOUND_SPEED_UP], 440.0f, 440.0f, 0.08f, 0.3f, true);
+        addTone(sounds[SOUND_SPEED_UP], 554.0f, 554.0f, 0.08f, 0.3f, true);
+        addTone(sounds[SOUND_SPEED_UP], 659.0f, 659.0f, 0.15f, 0.3f, true);
+        addTone(sounds[SOUND_GAME_OVER], 400.0f, 90.0f, 0.6f, 0.35f, true);
+    }
+
+public:
+    AudioMixer() : device(0), sampleRate(0), started(0) {
+        for (auto& voice : voices) {
+            voice.samples = nullptr;
+            voice.length = 0;
+            voice.position = 0;
+        }
+        std::fill(posted, posted + SOUND_EFFECT_COUNT, 0u);
+    }
+
+    // bufferSamples is the callback period, which bounds the play latency.
+    // Returns false if there is no usable audio device; the game then runs silent.
+    bool initialize(int bufferSamples) {
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+            std::cerr << "SDL audio could not initialize! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        SDL_AudioSpec desired = {};
+        desired.freq = 48000;
+        desired.format = AUDIO_S16SYS;
+        desired.channels = 1;
+        desired.samples = static_cast<Uint16>(bufferSamples);
+        desired.callback = audioCallback;
+        desired.userdata = this;
+
+        SDL_AudioSpec obtained;
+        device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+        if (device == 0) {
+            std::cerr << "Audio device could not be opened! SDL Error: " << SDL_GetError() << std::endl;
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+            return false;
+        }
+
+        // Synthesize at whatever rate the device gave us so no resampling is needed
+        sampleRate = obtained.freq;
+        synthesizeSounds();
+        SDL_PauseAudioDevice(device, 0);
+        return true;
+    }
+
+    // Called from the game thread; never blocks
+    void play(SoundEffect sound) {
+        if (device == 0) {
+            return;
+        }
+        AudioCommand command;
+        command.sound = static_cast<uint8_t>(sound);
+        if (commands.push(command)) {  // A full queue just drops the sound
+            posted[sound]++;
+        }
+    }
+
+    bool isOpen() const {
+        return device != 0;
+    }
+
+    // Sounds of this kind handed to the audio thread so far
+    unsigned int postedCount(SoundEffect sound) const {
+        return posted[sound];
+    }
+
+    unsigned int postedTotal() const {
+        unsigned int total = 0;
+        for (unsigned int count : posted) {
+            total += count;
+        }
+        return total;
+    }
+
+    // Sounds the audio callback has actually started mixing
+    unsigned int startedCount() const {
+        return started.load(std::memory_order_relaxed);
+    }
+
+    void clean() {
+        if (device != 0) {
+            SDL_CloseAudioDevice(device);
+            device = 0;
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        }
+    }
+
+    ~AudioMixer() {
+        clean();
+    }
+};
+
+const int AudioMixer::MIX_CHUNK;  // Bound by reference in std::min
+
+// Submits scores to the leaderboard service and fetches the top entries.
+// All networking happens on a worker thread: the game thread only touches
+// a few in-memory fields under a mutex that is never held across socket
+// calls. Scores that could not be sent survive restarts in a queue file.
+class LeaderboardClient {
+private:
+    static const int SOCKET_TIMEOUT_MS = 2000;
+    static const Uint32 INITIAL_BACKOFF_MS = 500;
+    static const Uint32 MAX_BACKOFF_MS = 30000;
+    static const int TOP_COUNT = 5;
+
+    std::string host;
+    int port;
+    std::string playerName;
+    bool persistent;  // Keep unsent scores in the queue file
+    SDL_Thread* thread;
+    SDL_mutex* mutex;
+    SDL_cond* wake;
+
+    // Guarded by mutex
+    bool running;
+    Uint32 backoff;                   // Wait before the next attempt, 0 when the last one worked
+    std::vector<unsigned int> queue;  // Scores not yet accepted by the server
+    bool queueDirty;                  // Queue file is out of date
+    bool topWanted;
+    std::vector<std::string> topEntries;
+
+    static int workerThread(void* data) {
+        static_cast<LeaderboardClient*>(data)->work();
+        return 0;
+    }
+
+    // One HTTP/1.0 exchange; returns the body of a 200 reply
+    bool exchange(const std::string& method, const std::string& path, const std::string& body, std::string& reply) {
+        NetSocket connection;
+        if (!connection.connectTo(host, port, SOCKET_TIMEOUT_MS)) {
+            return false;
+        }
+        std::string request = method + " " + path + " HTTP/1.0\r\nHost: " + host +
+                              "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        std::string response;
+        if (!connection.sendAll(request) || !connection.receiveAll(response, 64 * 1024)) {
+            return false;
+        }
+        if (response.compare(0, 12, "HTTP/1.0 200") != 0 && response.compare(0, 12, "HTTP/1.1 200") != 0) {
+            return false;
+        }
+        size_t bodyStart = response.find("\r\n\r\n");
+        reply = bodyStart == std::string::npos ? "" : response.substr(bodyStart + 4);
+        return true;
+    }
+
+    bool postScores(const std::vector<unsigned int>& scores) {
+        // Everything queued goes out in one request
+        std::string body;
+        for (unsigned int score : scores) {
+            body += playerName + " " + std::to_string(score) + "\n";
+        }
+        std::string reply;
+        return exchange("POST", "/scores", body, reply);
+    }
+
+    bool fetchTop(std::vector<std::string>& entries) {
+        std::string reply;
+        if (!exchange("GET", "/top?n=" + std::to_string(TOP_COUNT), "", reply)) {
+            return false;
+        }
+        entries.clear();
+        size_t start = 0;
+        while (start < reply.size()) {
+            size_t end = reply.find('\n', start);
+            if (end == std::string::npos) {
+                end = reply.size();
+            }
+            if (end > start) {
+                entries.push_back(reply.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return true;
+    }
+
+    void loadQueue() {
+        if (!persistent) {
+            return;
+        }
+        std::ifstream file(LEADERBOARD_QUEUE_FILE);
+        unsigned int score;
+        std::vector<unsigned int> saved;
+        while (file >> score) {
+            saved.push_back(score);
+        }
+        if (!saved.empty()) {
+            SDL_LockMutex(mutex);
+            queue.insert(queue.begin(), saved.begin(), saved.end());
+            SDL_UnlockMutex(mutex);
+        }
+    }
+
+    void saveQueue(const std::vector<unsigned int>& scores) {
+        if (!persistent) {
+            return;
+        }
+        std::ofstream file(LEADERBOARD_QUEUE_FILE);
+        for (unsigned int score : scores) {
+            file << score << "\n";
+        }
+    }
+
+    void work() {
+        loadQueue();
+
+        SDL_LockMutex(mutex);
+        while (running) {
+            if (backoff > 0) {
+                // Only stop cuts a backoff short; new scores wait in the queue
+                Uint32 retryAt = SDL_GetTicks() + backoff;
+                Sint32 left;
+                while (running && (left = static_cast<Sint32>(retryAt - SDL_GetTicks())) > 0) {
+                    SDL_CondWaitTimeout(wake, mutex, static_cast<Uint32>(left));
+                }
+            } else if (queue.empty() && !topWanted && !queueDirty) {
+                SDL_CondWait(wake, mutex);
+            }
+            if (!running) {
+                break;
+            }
+
+            std::vector<unsigned int> batch = queue;
+            bool wantTop = topWanted;
+            bool dirty = queueDirty;
+            queueDirty = false;
+            SDL_UnlockMutex(mutex);
+
+            if (dirty) {
+                saveQueue(batch);
+            }
+
+            bool ok = true;
+            if (!batch.empty()) {
+                ok = postScores(batch);
+                if (ok) {
+                    SDL_LockMutex(mutex);
+                    queue.erase(queue.begin(), queue.begin() + batch.size());
+                    queueDirty = true;
+                    SDL_UnlockMutex(mutex);
+                }
+            }
+            std::vector<std::string> entries;
+            if (ok && wantTop) {
+                ok = fetchTop(entries);
+            }
+
+            SDL_LockMutex(mutex);
+            if (ok && wantTop) {
+                topEntries = entries;
+                topWanted = false;
+            }
+            Uint32 doubled = backoff == 0 ? INITIAL_BACKOFF_MS : backoff * 2;
+            backoff = ok ? 0 : (doubled > MAX_BACKOFF_MS ? MAX_BACKOFF_MS : doubled);
+        }
+        std::vector<unsigned int> unsent = queue;
+        SDL_UnlockMutex(mutex);
+
+        saveQueue(unsent);
+    }
+
+public:
+    LeaderboardClient() : port(0), persistent(true), thread(nullptr), mutex(nullptr), wake(nullptr),
+                          running(false), backoff(0), queueDirty(false), topWanted(false) {}
+
+    bool start(const std::string& serverHost, int serverPort, const std::string& name, bool persistQueue) {
+        host = serverHost;
+        port = serverPort;
+        playerName = name;
+        persistent = persistQueue;
+        if (!NetSocket::startup()) {
+            std::cerr << "Networking could not initialize" << std::endl;
+            return false;
+        }
+        mutex = SDL_CreateMutex();
+        wake = SDL_CreateCond();
+        running = true;
+        thread = SDL_CreateThread(workerThread, "Leaderboard", this);
+        if (!thread) {
+            std::cerr << "Could not start leaderboard thread! SDL Error: " << SDL_GetError() << std::endl;
+            running = false;
+            return false;
+        }
+        return true;
+    }
+
+    void submit(unsigned int score) {
+        if (!thread) {
+            return;
+        }
+        SDL_LockMutex(mutex);
+        queue.push_back(score);
+        queueDirty = true;
+        if (backoff == 0) {
+            SDL_CondSignal(wake);
+        }
+        SDL_UnlockMutex(mutex);
+    }
+
+    void requestTopScores() {
+        if (!thread) {
+            return;
+        }
+        SDL_LockMutex(mutex);
+        topWanted = true;  // Repeated requests collapse into one fetch
+        if (backoff == 0) {
+            SDL_CondSignal(wake);
+        }
+        SDL_UnlockMutex(mutex);
+    }
+
+    // Copies the latest top entries and reports whether they changed; keeps
+    // the old copy rather than wait for the lock
+    bool copyTopScores(std::vector<std::string>& entries) {
+        bool changed = false;
+        if (thread && SDL_TryLockMutex(mutex) == 0) {
+            changed = entries != topEntries;
+            if (changed) {
+                entries = topEntries;
+            }
+            SDL_UnlockMutex(mutex);
+        }
+        return changed;
+    }
+
+    // Waits for an exchange in flight, at most the socket timeout
+    void stop() {
+        if (thread) {
+            SDL_LockMutex(mutex);
+            running = false;
+            SDL_CondSignal(wake);
+            SDL_UnlockMutex(mutex);
+            SDL_WaitThread(thread, nullptr);
+            thread = nullptr;
+            NetSocket::shutdown();
+        }
+        if (wake) {
+            SDL_DestroyCond(wake);
+            wake = nullptr;
+        }
+        if (mutex) {
+            SDL_DestroyMutex(mutex);
+            mutex = nullptr;
+        }
+    }
+
+    ~LeaderboardClient() {
+        stop();
+    }
+};
+
+class TextManager {
+private:
+    TTF_Font* font;
     TTF_Font* largeFont;
     SDL_Color textColor;
+    bool smooth;  // Anti-aliased glyphs; solid ones are cheaper to rasterize
     
 public:
-    TextManager() : font(nullptr), largeFont(nullptr) {
+    TextManager() : font(nullptr), largeFont(nullptr), smooth(true) {
         textColor = {0, 0, 0, 255}; // Black
     }
     
-    bool initialize() {
+    bool initialize(const AssetPack& assets) {
         if (TTF_Init() == -1) {
             std::cerr << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << std::endl;
             return false;
         }
         
-        // If arial.ttf doesn't exist in your project, you may need to adjust the path or use a different font
-        font = TTF_OpenFont(FONT_FILE.c_str(), 24);
-        if (!font) {
-            // Try a fallback font if arial.ttf is not found
-            font = TTF_OpenFont("C:\\Windows\\Fonts\\arial.ttf", 24);
-            if (!font) {
-                std::cerr << "Failed to load font! SDL_ttf Error: " << TTF_GetError() << std::endl;
-                std::cerr << "Using default rendering method instead." << std::endl;
+        // Both sizes read the same mapped font data
+        font = openFont(assets, 24);
+        largeFont = openFont(assets, 28);
+        return font && largeFont;
+    }
+    
+    TTF_Font* openFont(const AssetPack& assets, int size) {
+        SDL_RWops* data = assets.openAsset(FONT_ASSET);
+        if (!data) {
+            return nullptr;
+        }
+        TTF_Font* loaded = TTF_OpenFontRW(data, 1, size);
+        if (!loaded) {
+            std::cerr << "Failed to load font " << FONT_ASSET << "! SDL_ttf Error: " << TTF_GetError() << std::endl;
+        }
+        return loaded;
+    }
+    
+    void setSmooth(bool antiAliased) {
+        smooth = antiAliased;
+    }
+    
+    void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, bool useLargeFont = false) {
+        TTF_Font* currentFont = useLargeFont ? largeFont : font;
+        
+        SDL_Surface* textSurface = smooth ? TTF_RenderText_Blended(currentFont, text.c_str(), textColor)
+                                          : TTF_RenderText_Solid(currentFont, text.c_str(), textColor);
+        if (textSurface) {
+            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+            if (textTexture) {
+                SDL_Rect renderQuad = {x, y, textSurface->w, textSurface->h};
+                SDL_RenderCopy(renderer, textTexture, nullptr, &renderQuad);
+                SDL_DestroyTexture(textTexture);
+            }
+            SDL_FreeSurface(textSurface);
+        }
+    }
+    
+    ~TextManager() {
+        if (font) {
+            TTF_CloseFont(font);
+            font = nullptr;
+        }
+        
+        if (largeFont) {
+            TTF_CloseFont(largeFont);
+            largeFont = nullptr;
+        }
+        
+        TTF_Quit();
+    }
+};
+
+// Detail levels, cheapest first. Each level adds to the one below it.
+enum QualityLevel {
+    QUALITY_MINIMAL,  // Sky, city and road only, solid text
+    QUALITY_LOW,      // Clouds
+    QUALITY_REDUCED,  // Far skyline and anti-aliased text
+    QUALITY_FULL,     // Obstacle decorations
+    QUALITY_LEVEL_COUNT
+};
+
+// Scrolling background made of horizontally tiling texture strips.
+// Every layer is drawn with a single SDL_RenderGeometry call no matter
+// how much detail was baked into its strip.
+class Parallax {
+private:
+    struct Layer {
+        SDL_Texture* strip;
+        int stripWidth;
+        int stripHeight;
+        float y;
+        float scrollFactor;  // 1.0 moves with the obstacles, 0.0 stays put
+        float offset;        // Sub-pixel scroll position inside the strip
+        bool visible;        // Hidden layers still scroll so they reappear in place
+    };
+
+    std::vector<Layer> layers;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    void appendQuad(float x0, float x1, float y0, float y1, float u0, float u1) {
+        const SDL_Color white = {255, 255, 255, 255};
+        int base = static_cast<int>(vertices.size());
+        vertices.push_back({{x0, y0}, white, {u0, 0.0f}});
+        vertices.push_back({{x1, y0}, white, {u1, 0.0f}});
+        vertices.push_back({{x1, y1}, white, {u1, 1.0f}});
+        vertices.push_back({{x0, y1}, white, {u0, 1.0f}});
+        int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        indices.insert(indices.end(), quad, quad + 6);
+    }
+
+public:
+    // Takes ownership of the strip texture; returns the layer's index
+    size_t addLayer(SDL_Texture* strip, float y, float scrollFactor) {
+        Layer layer;
+        layer.strip = strip;
+        SDL_QueryTexture(strip, nullptr, nullptr, &layer.stripWidth, &layer.stripHeight);
+        layer.y = y;
+        layer.scrollFactor = scrollFactor;
+        layer.offset = 0.0f;
+        layer.visible = true;
+        layers.push_back(layer);
+        return layers.size() - 1;
+    }
+
+    void setVisible(size_t layer, bool visible) {
+        if (layer < layers.size()) {
+            layers[layer].visible = visible;
+        }
+    }
+
+    void update(float distance) {
+        for (auto& layer : layers) {
+            layer.offset += distance * layer.scrollFactor;
+            if (layer.offset >= layer.stripWidth) {
+                layer.offset = std::fmod(layer.offset, static_cast<float>(layer.stripWidth));
+            }
+        }
+    }
+
+    void seek(double distance) {
+        for (auto& layer : layers) {
+            layer.offset = static_cast<float>(std::fmod(distance * layer.scrollFactor, layer.stripWidth));
+        }
+    }
+
+    void render(SDL_Renderer* renderer) {
+        for (const auto& layer : layers) {
+            if (!layer.visible) {
+                continue;
+            }
+            vertices.clear();
+            indices.clear();
+
+            // SDL2 clamps texture coordinates, so the wrap is done by
+            // splitting the strip into quads at each seam
+            float y0 = layer.y;
+            float y1 = layer.y + layer.stripHeight;
+            float screenX = 0.0f;
+            float stripX = layer.offset;
+            while (screenX < SCREEN_WIDTH) {
+                float span = std::min(layer.stripWidth - stripX, SCREEN_WIDTH - screenX);
+                appendQuad(screenX, screenX + span, y0, y1,
+                           stripX / layer.stripWidth, (stripX + span) / layer.stripWidth);
+                screenX += span;
+                stripX = 0.0f;
+            }
+
+            SDL_RenderGeometry(renderer, layer.strip, vertices.data(), static_cast<int>(vertices.size()),
+                               indices.data(), static_cast<int>(indices.size()));
+        }
+    }
+
+    void clear() {
+        for (auto& layer : layers) {
+            SDL_DestroyTexture(layer.strip);
+        }
+        layers.clear();
+    }
+
+    ~Parallax() {
+        clear();
+    }
+};
+
+class CityBackground {
+private:
+    static const int FAR_STRIP_WIDTH = SCREEN_WIDTH * 2;
+    static const int CLOUD_STRIP_WIDTH = SCREEN_WIDTH * 3;
+    static const int CITY_STRIP_WIDTH = SCREEN_WIDTH * 3;
+    static const int ROAD_STRIP_WIDTH = 100;  // One road marker period
+    static const int CLOUD_BAND_HEIGHT = 100;
+
+    Parallax parallax;
+    size_t farSkylineLayer;
+    size_t cloudLayer;
+    int detail;
+    
+    // Creates a transparent render target and makes it current
+    SDL_Texture* beginStrip(SDL_Renderer* renderer, int width, int height) {
+        SDL_Texture* strip = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                               SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!strip) {
+            std::cerr << "Could not create background strip! SDL Error: " << SDL_GetError() << std::endl;
+            return nullptr;
+        }
+        SDL_SetTextureBlendMode(strip, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderTarget(renderer, strip);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);  // Write alpha as-is into the strip
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        return strip;
+    }
+    
+    void endStrip(SDL_Renderer* renderer) {
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    }
+    
+    SDL_Texture* bakeFarSkyline(SDL_Renderer* renderer, uint64_t seed) {
+        SDL_Texture* strip = beginStrip(renderer, FAR_STRIP_WIDTH, GROUND_LEVEL);
+        if (!strip) {
+            return nullptr;
+        }
+        
+        // Hazy silhouettes, no windows at this distance
+        CounterRng random(seed, RNG_STREAM_FAR_SKYLINE);
+        SDL_SetRenderDrawColor(renderer, 150, 170, 195, 255);
+        int x = 0;
+        for (uint64_t tower = 0; x < FAR_STRIP_WIDTH; tower++) {
+            int width = std::min(random.range(tower, 0, 40, 99), FAR_STRIP_WIDTH - x);
+            int height = random.range(tower, 1, 150, 269);
+            SDL_Rect towerRect = {x, GROUND_LEVEL - height, width, height};
+            SDL_RenderFillRect(renderer, &towerRect);
+            x += width;
+        }
+        
+        endStrip(renderer);
+        return strip;
+    }
+    
+    SDL_Texture* bakeClouds(SDL_Renderer* renderer, uint64_t seed) {
+        SDL_Texture* strip = beginStrip(renderer, CLOUD_STRIP_WIDTH, CLOUD_BAND_HEIGHT);
+        if (!strip) {
+            return nullptr;
+        }
+        
+        CounterRng random(seed, RNG_STREAM_CLOUDS);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 200);  // White with slight transparency
+        for (int slot = 0; slot * 250 < CLOUD_STRIP_WIDTH; slot++) {
+            if (random.chance(slot, 0, 1, 3)) {
+                continue;  // Leave some gaps in the sky
+            }
+            SDL_Rect cloud = {
+                slot * 250 + random.range(slot, 1, 0, 99),
+                random.range(slot, 2, 20, 79),
+                random.range(slot, 3, 40, 99),
+                random.range(slot, 4, 15, 29)
+            };
+            SDL_RenderFillRect(renderer, &cloud);
+            
+            // Add some detail to clouds
+            SDL_Rect cloudDetail = {cloud.x + cloud.w/4, cloud.y - cloud.h/2, cloud.w/2, cloud.h};
+            SDL_RenderFillRect(renderer, &cloudDetail);
+        }
+        
+        endStrip(renderer);
+        return strip;
+    }
+    
+    SDL_Texture* bakeCity(SDL_Renderer* renderer, uint64_t seed) {
+        SDL_Texture* strip = beginStrip(renderer, CITY_STRIP_WIDTH, GROUND_LEVEL);
+        if (!strip) {
+            return nullptr;
+        }
+        
+        CounterRng random(seed, RNG_STREAM_SKYLINE);
+        CounterRng windowRandom(seed, RNG_STREAM_WINDOWS);
+        
+        int windowSize = 12;
+        int windowGap = 8;
+        int x = 0;
+        for (uint64_t building = 0; x < CITY_STRIP_WIDTH; building++) {
+            // The last building is clipped to the strip so the seam lines up
+            int width = std::min(random.range(building, 0, 60, 120), CITY_STRIP_WIDTH - x);
+            int height = random.range(building, 1, 100, 250);
+            
+            // Random building color (grayish)
+            SDL_SetRenderDrawColor(renderer, random.range(building, 2, 100, 179), random.range(building, 3, 100, 179),
+                                   random.range(building, 4, 100, 179), 255);
+            SDL_Rect buildingRect = {x, GROUND_LEVEL - height, width, height};
+            SDL_RenderFillRect(renderer, &buildingRect);
+            
+            // Windows (lights on)
+            SDL_SetRenderDrawColor(renderer, 255, 255, 200, 255);  // Warm yellow light
+            for (int row = 0; row < (height - 20) / (windowSize + windowGap); row++) {
+                for (int col = 0; col < (width - 20) / (windowSize + windowGap); col++) {
+                    // 10% chance of light being off
+                    uint64_t windowIndex = (building << 16) | (static_cast<uint64_t>(row) << 8) | col;
+                    if (!windowRandom.chance(windowIndex, 0, 1, 10)) {
+                        SDL_Rect window = {
+                            x + 10 + col * (windowSize + windowGap),
+                            GROUND_LEVEL - height + 20 + row * (windowSize + windowGap),
+                            windowSize, windowSize
+                        };
+                        SDL_RenderFillRect(renderer, &window);
+                    }
+                }
+            }
+            
+            x += width - 5;  // Slight overlap
+            if (width < 10) {
+                break;
+            }
+        }
+        
+        endStrip(renderer);
+        return strip;
+    }
+    
+    SDL_Texture* bakeRoad(SDL_Renderer* renderer) {
+        SDL_Texture* strip = beginStrip(renderer, ROAD_STRIP_WIDTH, SCREEN_HEIGHT - GROUND_LEVEL);
+        if (!strip) {
+            return nullptr;
+        }
+        
+        // Ground
+        SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);  // Gray cement
+        SDL_RenderClear(renderer);
+        
+        // Sidewalk
+        SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);  // Light gray
+        SDL_Rect sidewalk = {0, 0, ROAD_STRIP_WIDTH, 20};
+        SDL_RenderFillRect(renderer, &sidewalk);
+        
+        // Road marker
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);  // White
+        SDL_Rect roadMarker = {0, 40, 50, 10};
+        SDL_RenderFillRect(renderer, &roadMarker);
+        
+        endStrip(renderer);
+        return strip;
+    }
+    
+    // Returns the layer index, or SIZE_MAX when the strip could not be baked
+    size_t addLayer(SDL_Texture* strip, float y, float scrollFactor) {
+        return strip ? parallax.addLayer(strip, y, scrollFactor) : SIZE_MAX;
+    }
+    
+public:
+    CityBackground() : farSkylineLayer(SIZE_MAX), cloudLayer(SIZE_MAX), detail(QUALITY_FULL) {}
+    
+    // Bakes every layer once; needs a renderer that supports render targets.
+    // The same seed always produces the same skyline.
+    void initialize(SDL_Renderer* renderer, uint64_t seed) {
+        parallax.clear();
+        farSkylineLayer = addLayer(bakeFarSkyline(renderer, seed), 0.0f, 0.15f);
+        cloudLayer = addLayer(bakeClouds(renderer, seed), 0.0f, 0.25f);
+        addLayer(bakeCity(renderer, seed), 0.0f, 0.5f);   // Buildings move slower than obstacles
+        addLayer(bakeRoad(renderer), GROUND_LEVEL, 1.0f);
+        setDetail(detail);
+    }
+    
+    // Windows and cloud detail are baked into the strips and cost nothing per
+    // frame; what costs is overdraw, so lower levels skip whole layers
+    void setDetail(int level) {
+        detail = level;
+        parallax.setVisible(farSkylineLayer, level >= QUALITY_REDUCED);
+        parallax.setVisible(cloudLayer, level >= QUALITY_LOW);
+    }
+    
+    void update(int gameSpeed) {
+        parallax.update(static_cast<float>(gameSpeed));
+    }
+    
+    // Jumps straight to how the background looks after travelling distance
+    void seek(int64_t distance) {
+        parallax.seek(static_cast<double>(distance));
+    }
+    
+    void render(SDL_Renderer* renderer) {
+        // Draw sky
+        SDL_SetRenderDrawColor(renderer, 135, 206, 235, 255);  // Sky blue
+        SDL_Rect sky = {0, 0, SCREEN_WIDTH, GROUND_LEVEL};
+        SDL_RenderFillRect(renderer, &sky);
+        
+        parallax.render(renderer);
+    }
+    
+    void clean() {
+        parallax.clear();
+    }
+};
+
+// Game moments a script can wait for
+enum GameEvent {
+    GAME_EVENT_JUMP,
+    GAME_EVENT_SCORED_JUMP,
+    GAME_EVENT_SPEED_UP,
+    GAME_EVENT_NEW_LEAD,  // Some runner, bots included, raised the best score of the run
+    GAME_EVENT_COUNT
+};
+
+// What a script is suspended on, returned from every resume
+struct ScriptWait {
+    enum Kind { FRAMES, DISTANCE, EVENT, DONE };
+    Kind kind;
+    int64_t value;
+
+    static ScriptWait frames(int64_t count) { return {FRAMES, count}; }
+    static ScriptWait distance(int64_t courseDistance) { return {DISTANCE, courseDistance}; }
+    static ScriptWait event(GameEvent gameEvent) { return {EVENT, gameEvent}; }
+    static ScriptWait done() { return {DONE, 0}; }
+};
+
+// The part of the game scripts may read and change
+class ScriptHost {
+public:
+    virtual ~ScriptHost() {}
+    virtual int64_t scriptDistance() const = 0;
+    virtual uint32_t scriptLeadingScore() const = 0;
+    virtual void spawnObstacle(int64_t courseX, ObstacleType type, int width, int height) = 0;
+    virtual void showBanner(const std::string& text, int frames) = 0;
+    virtual void speedUp() = 0;  // Raises the shared speed one step
+};
+
+// Stackless coroutines written as straight-line code. resume() runs from
+// the last await to the next one; anything that must survive an await is
+// a member, not a local. Only one SCRIPT_AWAIT per source line.
+#define SCRIPT_BEGIN switch (resumePoint) { case 0:
+#define SCRIPT_AWAIT(wait) do { resumePoint = __LINE__; return (wait); case __LINE__:; } while (0)
+#define SCRIPT_END } resumePoint = -1; return ScriptWait::done();
+
+class Script {
+protected:
+    int resumePoint = 0;
+
+public:
+    virtual ~Script() {}
+    virtual ScriptWait resume(ScriptHost& host) = 0;
+};
+
+// Fixed-size blocks for scripts, recycled through a free list so spawning
+// in steady state never touches the heap
+class ScriptPool {
+public:
+    static const size_t BLOCK_SIZE = 128;
+
+private:
+    static const size_t BLOCKS_PER_CHUNK = 64;
+
+    union Block {
+        Block* next;
+        alignas(std::max_align_t) unsigned char bytes[BLOCK_SIZE];
+    };
+
+    std::vector<std::unique_ptr<Block[]>> chunks;
+    Block* freeList = nullptr;
+
+public:
+    void* allocate() {
+        if (!freeList) {
+            chunks.emplace_back(new Block[BLOCKS_PER_CHUNK]);
+            Block* chunk = chunks.back().get();
+            for (size_t i = 0; i < BLOCKS_PER_CHUNK; i++) {
+                chunk[i].next = freeList;
+                freeList = &chunk[i];
             }
         }
-        
-        largeFont = TTF_OpenFont(FONT_FILE.c_str(), 28);
-        if (!largeFont) {
-            // Try a fallback font if arial.ttf is not found
-            largeFont = TTF_OpenFont("C:\\Windows\\Fonts\\arial.ttf", 28);
-            if (!largeFont) {
-                std::cerr << "Failed to load large font! SDL_ttf Error: " << TTF_GetError() << std::endl;
-                std::cerr << "Using default rendering method instead." << std::endl;
-            }
+        Block* block = freeList;
+        freeList = block->next;
+        return block;
+    }
+
+    void release(void* memory) {
+        Block* block = static_cast<Block*>(memory);
+        block->next = freeList;
+        freeList = block;
+    }
+};
+
+// Resumes each script only when what it waits for has happened: frame and
+// distance waits sit in min-heaps and event waits in per-event lists, so
+// a frame costs nothing for scripts that are still waiting.
+class ScriptScheduler {
+private:
+    struct Timed {
+        int64_t at;
+        uint64_t order;  // Keeps resumption order deterministic on ties
+        Script* script;
+
+        bool operator>(const Timed& other) const {
+            return at != other.at ? at > other.at : order > other.order;
         }
-        
-        return true;
+    };
+
+    ScriptPool pool;
+    std::vector<Timed> frameWaits;
+    std::vector<Timed> distanceWaits;
+    std::vector<Script*> eventWaits[GAME_EVENT_COUNT];
+    std::vector<Script*> ready;
+    std::vector<Script*> deferred;  // What was ready while signalNow() ran
+    int64_t frame = 0;
+    uint64_t order = 0;
+
+    void destroy(Script* script) {
+        script->~Script();
+        pool.release(script);
     }
-    
-    void renderText(SDL_Renderer* renderer, const std::string& text, int x, int y, bool useLargeFont = false) {
-        TTF_Font* currentFont = useLargeFont ? largeFont : font;
-        
-        if (currentFont) {
-            // Use SDL_ttf for text rendering
-            SDL_Surface* textSurface = TTF_RenderText_Solid(currentFont, text.c_str(), textColor);
-            if (textSurface) {
-                SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-                if (textTexture) {
-                    SDL_Rect renderQuad = {x, y, textSurface->w, textSurface->h};
-                    SDL_RenderCopy(renderer, textTexture, nullptr, &renderQuad);
-                    SDL_DestroyTexture(textTexture);
-                }
-                SDL_FreeSurface(textSurface);
-            }
-        } else {
-            // Fallback to basic rendering if font couldn't be loaded
-            renderBasicText(renderer, text, x, y);
+
+    void push(std::vector<Timed>& heap, int64_t at, Script* script) {
+        heap.push_back({at, order++, script});
+        std::push_heap(heap.begin(), heap.end(), std::greater<Timed>());
+    }
+
+    // Moves every entry due by now onto the ready list
+    void collectDue(std::vector<Timed>& heap, int64_t now) {
+        while (!heap.empty() && heap.front().at <= now) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Timed>());
+            ready.push_back(heap.back().script);
+            heap.pop_back();
         }
     }
-    
-    void renderBasicText(SDL_Renderer* renderer, const std::string& text, int x, int y) {
-        // Simple fallback text rendering in case TTF font loading fails
-        int charWidth = 10;
-        int charHeight = 20;
-        
-        for (size_t i = 0; i < text.length(); i++) {
-            char c = text[i];
-            if (c != ' ') {  // Don't render spaces
-                SDL_Rect charRect = {x + static_cast<int>(i * charWidth), y, charWidth - 2, charHeight};
-                
-                // Different color for text
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                SDL_RenderDrawRect(renderer, &charRect);
+
+public:
+    template <typename T, typename... Args>
+    void spawn(Args&&... args) {
+        static_assert(sizeof(T) <= ScriptPool::BLOCK_SIZE, "Script too large for the pool");
+        ready.push_back(new (pool.allocate()) T(std::forward<Args>(args)...));
+    }
+
+    // Wakes every script waiting for the event; they run on the next run()
+    void signal(GameEvent event) {
+        std::vector<Script*>& waiting = eventWaits[event];
+        ready.insert(ready.end(), waiting.begin(), waiting.end());
+        waiting.clear();
+    }
+
+    // Wakes and runs the event's waiters at once, leaving other ready
+    // scripts for the next run()
+    void signalNow(GameEvent event, ScriptHost& host) {
+        deferred.swap(ready);
+        signal(event);
+        run(host);
+        ready.swap(deferred);
+    }
+
+    // Advances one frame and resumes what is due
+    void tick(ScriptHost& host) {
+        frame++;
+        collectDue(frameWaits, frame);
+        collectDue(distanceWaits, host.scriptDistance());
+        run(host);
+    }
+
+    // Resumes ready scripts, including any they spawn along the way
+    void run(ScriptHost& host) {
+        for (size_t i = 0; i < ready.size(); i++) {
+            Script* script = ready[i];
+            ScriptWait wait = script->resume(host);
+            switch (wait.kind) {
+                case ScriptWait::FRAMES:
+                    push(frameWaits, frame + std::max<int64_t>(1, wait.value), script);
+                    break;
+                case ScriptWait::DISTANCE:
+                    push(distanceWaits, wait.value, script);
+                    break;
+                case ScriptWait::EVENT:
+                    eventWaits[wait.value].push_back(script);
+                    break;
+                case ScriptWait::DONE:
+                    destroy(script);
+                    break;
             }
         }
+        ready.clear();
     }
-    
-    ~TextManager() {
-        if (font) {
-            TTF_CloseFont(font);
-            font = nullptr;
+
+    void clear() {
+        for (const Timed& timed : frameWaits) {
+            destroy(timed.script);
         }
-        
-        if (largeFont) {
-            TTF_CloseFont(largeFont);
-            largeFont = nullptr;
+        for (const Timed& timed : distanceWaits) {
+            destroy(timed.script);
         }
-        
-        TTF_Quit();
+        for (auto& waiting : eventWaits) {
+            for (Script* script : waiting) {
+                destroy(script);
+            }
+            waiting.clear();
+        }
+        for (Script* script : ready) {
+            destroy(script);
+        }
+        frameWaits.clear();
+        distanceWaits.clear();
+        ready.clear();
+        frame = 0;
+    }
+
+    ~ScriptScheduler() {
+        clear();
     }
 };
 
-class CityBackground {
+// Feeds the seeded course onto the screen as it scrolls into view
+class CourseScript : public Script {
 private:
-    struct Building {
-        int x;
-        int width;
-        int height;
-        int color[3];  // RGB values
-        std::vector<SDL_Rect> windows;
-    };
-    
-    std::vector<Building> buildings;
-    std::vector<SDL_Rect> clouds;
-    int lastCloudTime;
-    
+    uint64_t seed;
+    uint64_t index;
+    CourseObstacle next;
+
 public:
-    CityBackground() : lastCloudTime(0) {
-        initializeBuildings();
-        initializeClouds();
-    }
-    
-    void initializeBuildings() {
-        // Create a skyline of buildings
-        std::mt19937 rng(static_cast<unsigned int>(time(nullptr)));
-        std::uniform_int_distribution<int> heightDist(100, 250);
-        std::uniform_int_distribution<int> widthDist(60, 120);
-        
-        int x = 0;
-        while (x < SCREEN_WIDTH * 1.5) {  // Create more buildings than needed to scroll
-            Building building;
-            building.x = x;
-            building.width = widthDist(rng);
-            building.height = heightDist(rng);
-            
-            // Random building color (grayish)
-            building.color[0] = 100 + rand() % 80;
-            building.color[1] = 100 + rand() % 80;
-            building.color[2] = 100 + rand() % 80;
-            
-            // Add windows
-            int windowSize = 12;
-            int windowGap = 8;
-            
-            for (int row = 0; row < (building.height - 20) / (windowSize + windowGap); row++) {
-                for (int col = 0; col < (building.width - 20) / (windowSize + windowGap); col++) {
-                    SDL_Rect window = {
-                        building.x + 10 + col * (windowSize + windowGap),
-                        GROUND_LEVEL - building.height + 20 + row * (windowSize + windowGap),
-                        windowSize, windowSize
-                    };
-                    
-                    // 10% chance of light being off
-                    if (rand() % 10 > 0) {
-                        building.windows.push_back(window);
-                    }
-                }
+    CourseScript(uint64_t courseSeed, uint64_t firstIndex) : seed(courseSeed), index(firstIndex) {}
+
+    ScriptWait resume(ScriptHost& host) override {
+        SCRIPT_BEGIN
+        while (true) {
+            if (isSetPieceObstacle(index)) {
+                index++;  // SetPieceScript plays these
+                continue;
             }
-            
-            buildings.push_back(building);
-            x += building.width - 5;  // Slight overlap
+            next = courseObstacle(seed, index);
+            if (next.courseX - host.scriptDistance() <= SCREEN_WIDTH) {
+                host.spawnObstacle(next.courseX, next.type, OBSTACLE_SIZES[next.type][0], OBSTACLE_SIZES[next.type][1]);
+                index++;
+                continue;
+            }
+            SCRIPT_AWAIT(ScriptWait::distance(next.courseX - SCREEN_WIDTH));
         }
+        SCRIPT_END
     }
-    
-    void initializeClouds() {
-        // Create some initial clouds
-        for (int i = 0; i < 3; i++) {
-            SDL_Rect cloud = {
-                rand() % SCREEN_WIDTH,
-                20 + rand() % 60,
-                40 + rand() % 60,
-                15 + rand() % 15
-            };
-            clouds.push_back(cloud);
+};
+
+// Plays the seeded course's set pieces: warns of each one as it nears,
+// then brings its obstacles on one by one
+class SetPieceScript : public Script {
+private:
+    static const int WARNING_DISTANCE = 600;  // Course distance between the warning and the first obstacle
+    static const int BANNER_FRAMES = 120;
+
+    uint64_t seed;
+    uint64_t index;
+    CourseObstacle next;
+
+public:
+    SetPieceScript(uint64_t courseSeed, uint64_t firstIndex) : seed(courseSeed), index(firstIndex) {}
+
+    ScriptWait resume(ScriptHost& host) override {
+        SCRIPT_BEGIN
+        while (true) {
+            if (!isSetPieceObstacle(index)) {
+                index = nextSetPieceFrom(index);
+                next = courseObstacle(seed, index);
+                SCRIPT_AWAIT(ScriptWait::distance(next.courseX - SCREEN_WIDTH - WARNING_DISTANCE));
+                host.showBanner("Road works ahead", BANNER_FRAMES);
+            }
+            next = courseObstacle(seed, index);
+            if (next.courseX - host.scriptDistance() > SCREEN_WIDTH) {
+                SCRIPT_AWAIT(ScriptWait::distance(next.courseX - SCREEN_WIDTH));
+            }
+            host.spawnObstacle(next.courseX, next.type, OBSTACLE_SIZES[next.type][0], OBSTACLE_SIZES[next.type][1]);
+            index++;
         }
+        SCRIPT_END
     }
-    
-    void update(int gameSpeed) {
-        // Move buildings
-        for (auto& building : buildings) {
-            building.x -= gameSpeed / 2;  // Parallax effect - buildings move slower than obstacles
-            
-            // Update window positions
-            for (auto& window : building.windows) {
-                window.x -= gameSpeed / 2;
-            }
-            
-            // If building is off screen, move it to the right
-            if (building.x + building.width < 0) {
-                int maxX = 0;
-                for (const auto& b : buildings) {
-                    maxX = std::max(maxX, b.x + b.width);
-                }
-                
-                int oldX = building.x;
-                building.x = maxX - 5;  // Place after the rightmost building with slight overlap
-                int xDiff = building.x - oldX;
-                
-                // Update window positions for the recycled building
-                for (auto& window : building.windows) {
-                    window.x += xDiff;
+};
+
+// Streams an authored course onto the screen as it scrolls into view
+class AuthoredCourseScript : public Script {
+private:
+    AuthoredCourse& course;
+    uint64_t next;
+
+public:
+    AuthoredCourseScript(AuthoredCourse& authored, uint64_t first) : course(authored), next(first) {
+        course.restartAt(first);
+    }
+
+    ScriptWait resume(ScriptHost& host) override {
+        SCRIPT_BEGIN
+        while (next < course.size()) {
+            if (course.record(next).courseX - host.scriptDistance() <= SCREEN_WIDTH) {
+                // Records are only checked as they stream in, so opening stays instant
+                const CourseRecord& record = course.record(next);
+                if (isPlayableRecord(record)) {
+                    host.spawnObstacle(record.courseX, static_cast<ObstacleType>(record.type), record.width, record.height);
+                } else {
+                    std::cerr << "Skipping unplayable obstacle at course distance " << record.courseX << std::endl;
                 }
-                
-                // Regenerate windows for variety
-                building.windows.clear();
-                int windowSize = 12;
-                int windowGap = 8;
-            
-                for (int row = 0; row < (building.height - 20) / (windowSize + windowGap); row++) {
-                    for (int col = 0; col < (building.width - 20) / (windowSize + windowGap); col++) {
-                        SDL_Rect window = {
-                            building.x + 10 + col * (windowSize + windowGap),
-                            GROUND_LEVEL - building.height + 20 + row * (windowSize + windowGap),
-                            windowSize, windowSize
-                        };
-                        
-                        // 10% chance of light being off
-                       // 10% chance of light being off
-                        if (rand() % 10 > 0) {
-                            building.windows.push_back(window);
-                        }
-                    }
+                if (++next % course.blockSize() == 0) {
+                    course.releaseBefore(next - course.blockSize());
                 }
+                continue;
             }
+            SCRIPT_AWAIT(ScriptWait::distance(course.record(next).courseX - SCREEN_WIDTH));
         }
-        
-        // Move clouds
-        for (auto& cloud : clouds) {
-            cloud.x -= gameSpeed / 4;  // Clouds move even slower than buildings
-            
-            // If cloud is off screen, move it to the right
-            if (cloud.x + cloud.w < 0) {
-                cloud.x = SCREEN_WIDTH + rand() % 100;
-                cloud.y = 20 + rand() % 60;
-                cloud.w = 40 + rand() % 60;
-                cloud.h = 15 + rand() % 15;
+        SCRIPT_END
+    }
+};
+
+// The difficulty phases: the shared speed steps up each time the leading
+// score passes another SPEED_UP_SCORE
+class DifficultyScript : public Script {
+private:
+    uint32_t nextSpeedUpScore = SPEED_UP_SCORE;
+
+public:
+    ScriptWait resume(ScriptHost& host) override {
+        SCRIPT_BEGIN
+        while (true) {
+            while (host.scriptLeadingScore() < nextSpeedUpScore) {
+                SCRIPT_AWAIT(ScriptWait::event(GAME_EVENT_NEW_LEAD));
             }
+            host.speedUp();
+            nextSpeedUpScore += SPEED_UP_SCORE;
         }
-        
-        // Maybe add a new cloud
-        int currentTime = SDL_GetTicks();
-        if (currentTime > lastCloudTime + 5000) {  // New cloud every 5 seconds
-            if (rand() % 3 == 0) {  // 33% chance
-                SDL_Rect cloud = {
-                    SCREEN_WIDTH + rand() % 100,
-                    20 + rand() % 60,
-                    40 + rand() % 60,
-                    15 + rand() % 15
-                };
-                clouds.push_back(cloud);
-                lastCloudTime = currentTime;
-            }
+        SCRIPT_END
+    }
+};
+
+// Announces each speed-up, at most once per banner
+class SpeedUpBannerScript : public Script {
+private:
+    static const int BANNER_FRAMES = 90;
+
+public:
+    ScriptWait resume(ScriptHost& host) override {
+        SCRIPT_BEGIN
+        while (true) {
+            SCRIPT_AWAIT(ScriptWait::event(GAME_EVENT_SPEED_UP));
+            host.showBanner("Faster!", BANNER_FRAMES);
+            SCRIPT_AWAIT(ScriptWait::frames(BANNER_FRAMES));
         }
+        SCRIPT_END
     }
+};
+
+// First run of a session: explains the controls until the first jump
+class JumpHintScript : public Script {
+public:
+    ScriptWait resume(ScriptHost& host) override {
+        SCRIPT_BEGIN
+        host.showBanner("Press SPACE to jump", 240);
+        SCRIPT_AWAIT(ScriptWait::event(GAME_EVENT_JUMP));
+        host.showBanner("", 0);
+        SCRIPT_END
+    }
+};
+
+enum ScaleFilter {
+    SCALE_INTEGER,  // Largest whole-number multiple that fits, crisp pixels
+    SCALE_LINEAR    // Fill the window, smoothed
+};
+
+struct GameOptions {
+    bool telemetry = true;      // Write a telemetry log for this session
+    uint64_t seed = 0;          // Fixed course and skyline seed, 0 for a new course every run
+    int64_t startDistance = 0;  // Course distance to start each run at, for practice
+    bool audio = true;
+    int audioBufferSamples = 512;  // Audio callback period, and so the sound latency
+    bool resizable = false;
+    bool fullscreen = false;       // Borderless fullscreen at the desktop resolution
+    ScaleFilter scaling = SCALE_INTEGER;
+    bool headless = false;         // No window: render with the software renderer into an offscreen surface
+    bool persistHighScore = true;
+    int quality = -1;              // Fixed QualityLevel, or -1 to adapt to the frame time
+    bool exportState = false;      // Publish every frame to shared memory for external tools
+    int bots = 0;                  // Computer runners sharing the course
+    bool splitKeys = false;        // A second player on the same keyboard jumps with W
+    bool ghost = false;            // Race a replay of your previous run
+    std::string coursePath;        // Authored course to play instead of the seeded one
+    std::string leaderboardHost;   // Empty disables the online leaderboard
+    std::string playerName = "Player";  // Name sent with each score; never taken from the OS login
+    int leaderboardPort = 8085;
+};
+
+// Moves the detail level to keep each frame's work inside the budget. A
+// level is dropped after a short stretch over budget and restored only
+// after a long stretch with headroom. When a restored level does not hold,
+// the next restore waits twice as long, so a machine right at the edge
+// settles on one level instead of flickering between two.
+class QualityScaler {
+private:
+    static constexpr double SMOOTHING = 0.1;   // Weight of the newest frame in the average
+    static constexpr double DROP_LOAD = 0.9;   // Share of the budget that counts as over
+    static constexpr double RAISE_LOAD = 0.6;  // Share of the budget that leaves headroom
+    static const int DROP_FRAMES = 30;
+    static const int RAISE_FRAMES = 180;
+    static const int MAX_RAISE_FRAMES = 3600;
+    static const int RAISE_TRIAL_FRAMES = 600;  // A drop this soon after a raise means the raise failed
+
+    double budgetMs;
+    double averageMs;
+    int level;
+    bool adaptive;
+    int overFrames;
+    int headroomFrames;
+    int raiseFrames;
+    int framesSinceRaise;
+
+public:
+    explicit QualityScaler(double frameBudgetMs) : budgetMs(frameBudgetMs), averageMs(0.0), level(QUALITY_FULL),
+        adaptive(true), overFrames(0), headroomFrames(0), raiseFrames(RAISE_FRAMES), framesSinceRaise(RAISE_TRIAL_FRAMES) {}
     
-    void render(SDL_Renderer* renderer) {
-        // Draw sky
-        SDL_SetRenderDrawColor(renderer, 135, 206, 235, 255);  // Sky blue
-        SDL_Rect sky = {0, 0, SCREEN_WIDTH, GROUND_LEVEL};
-        SDL_RenderFillRect(renderer, &sky);
-        
-        // Draw clouds
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 200);  // White with slight transparency
-        for (const auto& cloud : clouds) {
-            SDL_RenderFillRect(renderer, &cloud);
-            
-            // Add some detail to clouds
-            SDL_Rect cloudDetail = {cloud.x + cloud.w/4, cloud.y - cloud.h/2, cloud.w/2, cloud.h};
-            SDL_RenderFillRect(renderer, &cloudDetail);
-        }
-        
-        // Draw buildings
-        for (const auto& building : buildings) {
-            // Draw building
-            SDL_SetRenderDrawColor(renderer, building.color[0], building.color[1], building.color[2], 255);
-            SDL_Rect buildingRect = {building.x, GROUND_LEVEL - building.height, building.width, building.height};
-            SDL_RenderFillRect(renderer, &buildingRect);
-            
-            // Draw windows (lights on)
-            SDL_SetRenderDrawColor(renderer, 255, 255, 200, 255);  // Warm yellow light
-            for (const auto& window : building.windows) {
-                SDL_RenderFillRect(renderer, &window);
-            }
+    // Holds a fixed level from now on
+    void pin(int fixedLevel) {
+        level = std::max(0, std::min(QUALITY_LEVEL_COUNT - 1, fixedLevel));
+        adaptive = false;
+    }
+    
+    // Feeds one frame's update and render time; returns true when the level changed
+    bool observe(double frameMs) {
+        averageMs = averageMs == 0.0 ? frameMs : averageMs + SMOOTHING * (frameMs - averageMs);
+        if (!adaptive) {
+            return false;
         }
         
-        // Draw ground
-        SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);  // Gray cement
-        SDL_Rect ground = {0, GROUND_LEVEL, SCREEN_WIDTH, SCREEN_HEIGHT - GROUND_LEVEL};
-        SDL_RenderFillRect(renderer, &ground);
-        
-        // Draw sidewalk
-        SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);  // Light gray
-        SDL_Rect sidewalk = {0, GROUND_LEVEL, SCREEN_WIDTH, 20};
-        SDL_RenderFillRect(renderer, &sidewalk);
+        framesSinceRaise++;
+        overFrames = averageMs > budgetMs * DROP_LOAD ? overFrames + 1 : 0;
+        headroomFrames = averageMs < budgetMs * RAISE_LOAD ? headroomFrames + 1 : 0;
         
-        // Draw road markers
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);  // White
-        for (int x = 0; x < SCREEN_WIDTH; x += 100) {
-            SDL_Rect roadMarker = {x, GROUND_LEVEL + 40, 50, 10};
-            SDL_RenderFillRect(renderer, &roadMarker);
+        if (overFrames >= DROP_FRAMES && level > 0) {
+            level--;
+            raiseFrames = framesSinceRaise < RAISE_TRIAL_FRAMES ? std::min(raiseFrames * 2, MAX_RAISE_FRAMES) : RAISE_FRAMES;
+            overFrames = 0;
+            headroomFrames = 0;
+            return true;
+        }
+        if (headroomFrames >= raiseFrames && level < QUALITY_LEVEL_COUNT - 1) {
+            level++;
+            framesSinceRaise = 0;
+            overFrames = 0;
+            headroomFrames = 0;
+            return true;
         }
+        return false;
+    }
+    
+    int currentLevel() const {
+        return level;
+    }
+    
+    double averageFrameMs() const {
+        return averageMs;
     }
 };
 
-class Game {
+const int QualityScaler::MAX_RAISE_FRAMES;  // Bound by reference in std::min
+
+// What the main loop is doing, for pacing and the CPU report
+enum LoopState {
+    LOOP_PLAYING,
+    LOOP_GAME_OVER,
+    LOOP_PAUSED,
+    LOOP_HIDDEN,
+    LOOP_STATE_COUNT
+};
+
+const char* const LOOP_STATE_NAMES[LOOP_STATE_COUNT] = {"playing", "game over", "paused", "hidden"};
+
+class Game : public ScriptHost {
 private:
+    GameOptions options;
     SDL_Window* window;
     SDL_Renderer* renderer;
-    Player player;
+    SDL_Surface* headlessSurface;
+    SDL_Texture* sceneTarget;  // The scene is drawn here at SCREEN_WIDTH x SCREEN_HEIGHT, then scaled once
+    uint64_t backgroundSeed;
+    AssetPack assets;  // Declared before anything that reads from it
+    AuthoredCourse authoredCourse;  // Outlives the scripts streaming from it
+    SDL_Texture* characterTexture;
+    SpriteAtlas sprites;
+    int playerFrames;                             // Atlas frame of PLAYER_POSES[0]
+    std::map<uint64_t, int> obstacleFrames;       // Atlas frames by obstacle type and size
+    double animationMs;                           // Clock every animation plays against
+    Uint32 lastUpdateTicks;
+    RunnerCrowd runners;
+    std::vector<Player> humanViews;    // One per human runner, in runner order
+    std::vector<RunnerCrowd::GhostSample> runTrace;    // The player's line this run
+    std::vector<RunnerCrowd::GhostSample> ghostTrace;  // The same for the previous run
     std::vector<Obstacle> obstacles;
     ScoreManager scoreManager;
     TextManager textManager;
     CityBackground background;
+    TelemetryWriter telemetry;
+    StateExporter stateExport;
+    AudioMixer audio;
+    LeaderboardClient leaderboard;
+    std::vector<std::string> leaderboardLines;
     bool isRunning;
     bool gameOver;
+    bool paused;
+    bool hidden;       // Minimized or otherwise not visible
+    bool needsRedraw;  // Something on screen changed since the last render
     int gameSpeed;
-    unsigned int lastObstacleTime;
-    int obstacleSpawnDelay;
-    std::mt19937 rng;
+    int speedUps;
+    int runIndex;
+    uint64_t courseSeed;
+    int64_t distance;  // How far this run has scrolled
+    ScriptScheduler scripts;
+    std::string bannerText;
+    int bannerFrames;
+    QualityScaler quality;
+    bool obstacleDecorations;
+    bool showQualityReadout;
     
 public:
-    Game() : window(nullptr), renderer(nullptr), isRunning(false), gameOver(false), 
-            gameSpeed(GAME_SPEED_INITIAL), lastObstacleTime(0), obstacleSpawnDelay(2000) {
+    Game(const GameOptions& gameOptions = GameOptions()) : options(gameOptions), window(nullptr), renderer(nullptr),
+            headlessSurface(nullptr), sceneTarget(nullptr), backgroundSeed(0), characterTexture(nullptr), playerFrames(-1), animationMs(0.0), lastUpdateTicks(0), isRunning(false), gameOver(false), paused(false), hidden(false), needsRedraw(true), gameSpeed(GAME_SPEED_INITIAL),
+            speedUps(0), runIndex(0), courseSeed(0), distance(0), bannerFrames(0),
+            quality(1000.0 / 60), obstacleDecorations(true), showQualityReadout(false) {
+        if (!options.persistHighScore) {
+            scoreManager.disablePersistence();
+        }
+    }
+    
+    bool createWindowAndRenderer() {
+        Uint32 windowFlags = SDL_WINDOW_SHOWN;
+        if (options.resizable) {
+            windowFlags |= SDL_WINDOW_RESIZABLE;
+        }
+        if (options.fullscreen) {
+            windowFlags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+        }
+        window = SDL_CreateWindow("City Runner", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 
+                                 SCREEN_WIDTH, SCREEN_HEIGHT, windowFlags);
+        if (!window) {
+            std::cerr << "Window could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_SetWindowMinimumSize(window, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
         
-        // Initialize random number generator
-        rng.seed(static_cast<unsigned int>(time(nullptr)));
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
+        if (!renderer) {
+            std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    bool createOffscreenRenderer() {
+        headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!headlessSurface) {
+            std::cerr << "Offscreen surface could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        renderer = SDL_CreateSoftwareRenderer(headlessSurface);
+        if (!renderer) {
+            std::cerr << "Software renderer could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        return true;
     }
     
     bool initialize() {
-        // Initialize SDL
-        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        // Initialize SDL; offscreen rendering does not need a video driver
+        if (SDL_Init(options.headless ? 0 : SDL_INIT_VIDEO) < 0) {
             std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError() << std::endl;
             return false;
         }
@@ -808,26 +2751,61 @@ public:
         return false;
     }
         
-        // Create window
-        window = SDL_CreateWindow("City Runner", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 
-                                 SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-        if (!window) {
-            std::cerr << "Window could not be created! SDL Error: " << SDL_GetError() << std::endl;
+        if (!(options.headless ? createOffscreenRenderer() : createWindowAndRenderer())) {
             return false;
         }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
         
-        // Create renderer
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-        if (!renderer) {
-            std::cerr << "Renderer could not be created! SDL Error: " << SDL_GetError() << std::endl;
+        if (!createSceneTarget()) {
+            return false;
+        }
+        
+        backgroundSeed = options.seed != 0 ? options.seed : splitMix64(time(nullptr));
+        background.initialize(renderer, backgroundSeed);
+        
+        // Load assets
+        if (!assets.open(ASSET_PACK_FILE)) {
+            std::cerr << "Loading loose asset files instead; build the pack with asset_packer for faster startup." << std::endl;
+            assets.useLooseFiles();
+        }
+        
+        if (!options.coursePath.empty() && !authoredCourse.open(options.coursePath)) {
+            return false;
+        }
+        
+        if (!textManager.initialize(assets)) {
+            std::cerr << "Text manager could not initialize!" << std::endl;
+            return false;
+        }
+        
+        if (options.quality >= 0) {
+            quality.pin(options.quality);
+        }
+        applyQuality();
+        
+        if (!loadCharacter() || !bakeSprites()) {
             return false;
         }
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
         
-        // Initialize text manager
-        if (!textManager.initialize()) {
-            std::cerr << "Warning: Text manager initialization failed. Using fallback text rendering." << std::endl;
-            // Continue anyway, will use fallback rendering
+        if (options.audio && !audio.initialize(options.audioBufferSamples)) {
+            std::cerr << "Warning: Continuing without sound." << std::endl;
+        }
+        
+        if (!options.leaderboardHost.empty()) {
+            if (!leaderboard.start(options.leaderboardHost, options.leaderboardPort, options.playerName, options.persistHighScore)) {
+                std::cerr << "Warning: Leaderboard disabled for this session." << std::endl;
+            }
+        }
+        
+        if (options.telemetry) {
+            std::string logPath = TELEMETRY_FILE_PREFIX + std::to_string(time(nullptr)) + TELEMETRY_FILE_EXTENSION;
+            if (!telemetry.start(logPath)) {
+                std::cerr << "Warning: Telemetry disabled for this session." << std::endl;
+            }
+        }
+        
+        if (options.exportState && !stateExport.start()) {
+            std::cerr << "Warning: State export disabled for this session." << std::endl;
         }
         
         isRunning = true;
@@ -836,68 +2814,452 @@ public:
         return true;
     }
     
+    bool createSceneTarget() {
+        sceneTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                        SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!sceneTarget) {
+            std::cerr << "Scene render target could not be created! SDL Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_SetTextureScaleMode(sceneTarget, options.scaling == SCALE_LINEAR ? SDL_ScaleModeLinear : SDL_ScaleModeNearest);
+        return true;
+    }
+    
+    bool loadCharacter() {
+        SDL_RWops* characterData = assets.openAsset(CHARACTER_ASSET);
+        SDL_Surface* characterSurface = characterData ? IMG_Load_RW(characterData, 1) : nullptr;
+        if (!characterSurface) {
+            std::cerr << "Failed to load " << CHARACTER_ASSET << "! SDL_image Error: " << IMG_GetError() << std::endl;
+            return false;
+        }
+        characterTexture = SDL_CreateTextureFromSurface(renderer, characterSurface);
+        SDL_FreeSurface(characterSurface);
+        return true;
+    }
+    
+    // Everything animated is drawn from one atlas; the character image is
+    // only ever baked into it, where it must not be blended twice. When the
+    // atlas cannot be made, runners are drawn directly instead.
+    bool bakeSprites() {
+        playerFrames = -1;
+        if (!sprites.initialize(renderer)) {
+            sprites.clean();
+        } else {
+            if (characterTexture) {
+                SDL_SetTextureBlendMode(characterTexture, SDL_BLENDMODE_NONE);
+            }
+            SDL_Texture* character = characterTexture;
+            SDL_Rect playerArea = {PLAYER_X, GROUND_LEVEL - PLAYER_HEIGHT, PLAYER_WIDTH, PLAYER_HEIGHT};
+            playerFrames = sprites.addGroup(renderer, playerArea, PLAYER_POSE_COUNT, [character](SDL_Renderer* target, int frame) {
+                Player::drawPose(target, character, PLAYER_POSES[frame], PLAYER_X, GROUND_LEVEL - PLAYER_HEIGHT);
+            });
+            if (playerFrames < 0) {
+                std::cerr << "Player frames do not fit the sprite atlas!" << std::endl;
+            }
+        }
+        if (playerFrames < 0 && characterTexture) {
+            SDL_SetTextureBlendMode(characterTexture, SDL_BLENDMODE_BLEND);
+        }
+        return playerFrames >= 0;
+    }
+    
+    // A reset device has lost every texture, so all of them are made again.
+    // If the atlas cannot be, sprites are drawn directly until the next reset.
+    void recreateTextures() {
+        if (sceneTarget) {
+            SDL_DestroyTexture(sceneTarget);
+            sceneTarget = nullptr;
+        }
+        createSceneTarget();
+        background.initialize(renderer, backgroundSeed);
+        background.seek(distance);
+        
+        if (characterTexture) {
+            SDL_DestroyTexture(characterTexture);
+            characterTexture = nullptr;
+        }
+        loadCharacter();
+        
+        sprites.clean();
+        obstacleFrames.clear();
+        if (!bakeSprites()) {
+            std::cerr << "Warning: Drawing sprites without the atlas after the device reset." << std::endl;
+        }
+        for (auto& obstacle : obstacles) {
+            obstacle.firstFrame = spriteFramesFor(obstacle.type, obstacle.width, obstacle.height);
+        }
+        needsRedraw = true;
+    }
+    
     void resetGame() {
         // Reset game state
         obstacles.clear();
-        player = Player();
         gameOver = false;
+        paused = false;
         gameSpeed = GAME_SPEED_INITIAL;
-        lastObstacleTime = SDL_GetTicks();
         scoreManager.reset();
+        
+        // The run that just ended becomes the ghost, which only retraces it on the same course
+        bool racingGhost = options.ghost && !runTrace.empty();
+        ghostTrace.swap(runTrace);
+        runTrace.clear();
+        
+        // A fixed seed replays the same course every run, and so does racing a ghost
+        if (options.seed != 0) {
+            courseSeed = options.seed;
+        } else if (!racingGhost) {
+            courseSeed = nextRunSeed(time(nullptr), runIndex);
+        }
+        distance = options.startDistance;
+        int64_t firstObstacleX = distance + PLAYER_X + PLAYER_WIDTH + START_SAFE_DISTANCE;
+        background.seek(distance);
+        
+        int humanCount = options.splitKeys ? 2 : 1;
+        runners.reset(humanCount, racingGhost ? ghostTrace : std::vector<RunnerCrowd::GhostSample>(), options.bots, courseSeed);
+        humanViews.assign(humanCount, Player());
+        
+        // Each run starts its scripts afresh; the course fills the first screen right away
+        scripts.clear();
+        bannerFrames = 0;
+        if (authoredCourse.isOpen()) {
+            scripts.spawn<AuthoredCourseScript>(authoredCourse, authoredCourse.firstFrom(firstObstacleX));
+        } else {
+            uint64_t firstIndex = firstCourseObstacleFrom(courseSeed, firstObstacleX);
+            scripts.spawn<CourseScript>(courseSeed, firstIndex);
+            scripts.spawn<SetPieceScript>(courseSeed, firstIndex);
+        }
+        scripts.spawn<DifficultyScript>();
+        scripts.spawn<SpeedUpBannerScript>();
+        if (runIndex == 0) {
+            scripts.spawn<JumpHintScript>();
+        }
+        scripts.run(*this);
+        
+        telemetry.record(TELEMETRY_RUN_START, runIndex++, static_cast<int>(courseSeed & 0x7FFFFFFF));
+    }
+    
+    void handleEvent(const SDL_Event& e) {
+        if (e.type == SDL_QUIT) {
+            isRunning = false;
+        } else if (e.type == SDL_RENDER_TARGETS_RESET) {
+            // Some drivers drop render target contents on mode switches; rebake the strips
+            background.initialize(renderer, backgroundSeed);
+            background.seek(distance);
+            sprites.rebake(renderer);
+            needsRedraw = true;
+        } else if (e.type == SDL_RENDER_DEVICE_RESET) {
+            recreateTextures();
+        } else if (e.type == SDL_WINDOWEVENT) {
+            switch (e.window.event) {
+                case SDL_WINDOWEVENT_FOCUS_LOST:
+                    setPaused(true);
+                    break;
+                case SDL_WINDOWEVENT_MINIMIZED:
+                case SDL_WINDOWEVENT_HIDDEN:
+                    hidden = true;
+                    setPaused(true);
+                    break;
+                case SDL_WINDOWEVENT_RESTORED:
+                case SDL_WINDOWEVENT_SHOWN:
+                    hidden = false;
+                    needsRedraw = true;
+                    break;
+                case SDL_WINDOWEVENT_EXPOSED:
+                case SDL_WINDOWEVENT_SIZE_CHANGED:
+                    needsRedraw = true;
+                    break;
+            }
+        } else if (e.type == SDL_KEYDOWN) {
+            switch (e.key.keysym.sym) {
+                case SDLK_SPACE:
+                case SDLK_UP:
+                    pressJump(0);
+                    break;
+                case SDLK_w:
+                    if (options.splitKeys) {
+                        pressJump(1);
+                    }
+                    break;
+                case SDLK_p:
+                    setPaused(!paused);
+                    break;
+                case SDLK_F3:
+                    showQualityReadout = !showQualityReadout;
+                    needsRedraw = true;
+                    break;
+                case SDLK_F11:
+                    toggleFullscreen();
+                    break;
+                case SDLK_ESCAPE:
+                    isRunning = false;
+                    break;
+            }
+        }
     }
     
     void handleEvents() {
         SDL_Event e;
         while (SDL_PollEvent(&e) != 0) {
-            if (e.type == SDL_QUIT) {
-                isRunning = false;
-            } else if (e.type == SDL_KEYDOWN) {
-                switch (e.key.keysym.sym) {
-                    case SDLK_SPACE:
-                    case SDLK_UP:
-                        if (gameOver) {
-                            resetGame();
-                        } else {
-                            player.jump();
-                        }
-                        break;
-                    case SDLK_ESCAPE:
-                        isRunning = false;
-                        break;
-                }
+            handleEvent(e);
+        }
+    }
+    
+    // Sleeps until an event arrives or the timeout passes, then drains the queue
+    void waitForEvents(int timeoutMs) {
+        SDL_Event e;
+        if (SDL_WaitEventTimeout(&e, timeoutMs)) {
+            handleEvent(e);
+        }
+        handleEvents();
+    }
+    
+    // Only a run in progress can pause; the game-over screen is already still
+    void setPaused(bool pause) {
+        if (gameOver || pause == paused) {
+            return;
+        }
+        paused = pause;
+        needsRedraw = true;
+    }
+    
+    // Writes this frame's state straight into the shared ring slot
+    void publishState() {
+        if (!stateExport.isActive()) {
+            return;
+        }
+        StateExportSnapshot& snapshot = stateExport.beginFrame();
+        snapshot.distance = distance;
+        snapshot.playerX = PLAYER_X;
+        snapshot.playerY = runners.runnerY(0);
+        snapshot.playerVelocity = runners.runnerVelocity(0);
+        snapshot.score = scoreManager.getCurrentScore();
+        snapshot.gameSpeed = gameSpeed;
+        snapshot.gameOver = gameOver;
+        snapshot.jumping = runners.isJumping(0);
+        snapshot.paused = paused;
+        
+        // Obstacles are kept in course order; those the player has already
+        // passed linger until they leave the screen and are not exported
+        uint32_t count = 0;
+        for (auto it = obstacles.begin(); it != obstacles.end() && count < STATE_EXPORT_MAX_OBSTACLES; ++it) {
+            if (it->x + it->width < PLAYER_X) {
+                continue;
+            }
+            StateExportObstacle& exported = snapshot.obstacles[count++];
+            exported.x = it->x;
+            exported.width = static_cast<float>(it->width);
+            exported.height = static_cast<float>(it->height);
+            exported.type = it->type;
+        }
+        snapshot.obstacleCount = count;
+        stateExport.endFrame();
+    }
+    
+    void applyQuality() {
+        int level = quality.currentLevel();
+        background.setDetail(level);
+        textManager.setSmooth(level >= QUALITY_REDUCED);
+        obstacleDecorations = level >= QUALITY_FULL;
+        needsRedraw = true;
+    }
+    
+    LoopState loopState() const {
+        if (hidden) {
+            return LOOP_HIDDEN;
+        }
+        if (gameOver) {
+            return LOOP_GAME_OVER;
+        }
+        return paused ? LOOP_PAUSED : LOOP_PLAYING;
+    }
+    
+    int64_t scriptDistance() const override {
+        return distance;
+    }
+    
+    uint32_t scriptLeadingScore() const override {
+        return runners.leading();
+    }
+    
+    // Bakes the frames of each obstacle type and size the first time it shows up
+    int spriteFramesFor(ObstacleType type, int width, int height) {
+        const int stageX = 200;  // Far enough in for the margins on both sides
+        uint64_t key = (static_cast<uint64_t>(type) << 48) | (static_cast<uint64_t>(width) << 24) | static_cast<uint64_t>(height);
+        auto found = obstacleFrames.find(key);
+        if (found != obstacleFrames.end()) {
+            return found->second;
+        }
+        // Frames alternate without and with decorations
+        int frameCount = Obstacle::clipFor(type).frameCount * 2;
+        int first = sprites.addGroup(renderer, Obstacle::spriteArea(stageX, width, height), frameCount,
+                                     [type, width, height](SDL_Renderer* target, int frame) {
+            Obstacle(static_cast<float>(stageX), width, height, type).draw(target, frame % 2 == 1, frame / 2);
+        });
+        obstacleFrames[key] = first;  // -1 too: an obstacle that did not fit is drawn directly from then on
+        return first;
+    }
+    
+    void spawnObstacle(int64_t courseX, ObstacleType type, int width, int height) override {
+        // The course and set-piece scripts can both spawn in one frame, so
+        // find the obstacle's place in course order; it is nearly always last
+        float x = static_cast<float>(courseX - distance);
+        auto place = obstacles.end();
+        while (place != obstacles.begin() && (place - 1)->x > x) {
+            --place;
+        }
+        place = obstacles.emplace(place, x, width, height, type);
+        place->firstFrame = spriteFramesFor(type, width, height);
+        telemetry.record(TELEMETRY_SPAWN, width, height, type);
+    }
+    
+    void showBanner(const std::string& text, int frames) override {
+        bannerText = text;
+        bannerFrames = frames;
+    }
+    
+    void speedUp() override {
+        gameSpeed += GAME_SPEED_INCREMENT;
+        speedUps++;
+        telemetry.record(TELEMETRY_SPEED_UP, gameSpeed, static_cast<int>(distance));
+        audio.play(SOUND_SPEED_UP);
+        scripts.signal(GAME_EVENT_SPEED_UP);
+    }
+    
+    // A human's jump key: jumps while running, restarts after a crash, resumes when paused
+    void pressJump(int runner = 0) {
+        if (gameOver) {
+            resetGame();
+        } else if (paused) {
+            setPaused(false);
+        } else if (runners.jump(runner)) {
+            if (runner == 0) {
+                telemetry.record(TELEMETRY_JUMP, scoreManager.getCurrentScore());
             }
+            audio.play(SOUND_JUMP);
+            scripts.signal(GAME_EVENT_JUMP);
+        }
+    }
+    
+    bool isGameOver() const {
+        return gameOver;
+    }
+    
+    // Speed-ups over the whole session, across restarts
+    int speedUpCount() const {
+        return speedUps;
+    }
+    
+    int currentSpeed() const {
+        return gameSpeed;
+    }
+    
+    float playerY() const {
+        return runners.runnerY(0);
+    }
+    
+    const AudioMixer& sound() const {
+        return audio;
+    }
+    
+    // The last presented frame when running headless
+    SDL_Surface* offscreenFrame() const {
+        return headlessSurface;
+    }
+    
+    void toggleFullscreen() {
+        bool isFullscreen = (SDL_GetWindowFlags(window) & SDL_WINDOW_FULLSCREEN_DESKTOP) != 0;
+        if (SDL_SetWindowFullscreen(window, isFullscreen ? 0 : SDL_WINDOW_FULLSCREEN_DESKTOP) < 0) {
+            std::cerr << "Could not switch fullscreen mode! SDL Error: " << SDL_GetError() << std::endl;
+        }
+    }
+    
+    // Where the scene lands in the window, letterboxed to keep its aspect ratio
+    SDL_Rect presentRect() const {
+        int outputWidth, outputHeight;
+        SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+        
+        int width, height;
+        int wholeScale = std::min(outputWidth / SCREEN_WIDTH, outputHeight / SCREEN_HEIGHT);
+        if (options.scaling == SCALE_INTEGER && wholeScale >= 1) {
+            width = SCREEN_WIDTH * wholeScale;
+            height = SCREEN_HEIGHT * wholeScale;
+        } else {
+            // Linear scaling, or a window smaller than the scene
+            float scale = std::min(static_cast<float>(outputWidth) / SCREEN_WIDTH,
+                                   static_cast<float>(outputHeight) / SCREEN_HEIGHT);
+            width = static_cast<int>(SCREEN_WIDTH * scale);
+            height = static_cast<int>(SCREEN_HEIGHT * scale);
         }
+        SDL_Rect rect = {(outputWidth - width) / 2, (outputHeight - height) / 2, width, height};
+        return rect;
     }
     
     void update() {
         if (gameOver) {
+            // Nothing moves; only a newly fetched leaderboard changes the screen
+            if (leaderboard.copyTopScores(leaderboardLines)) {
+                needsRedraw = true;
+            }
             return;
         }
-        
-        // Update player
-        player.update();
-        
-        // Check for jump scoring
-        if (player.canScoreJump()) {
-            scoreManager.incrementJumpScore();
+        if (paused) {
+            return;
         }
-        
-        // Speed up game based on score
-        if (scoreManager.getCurrentScore() > 0 && scoreManager.getCurrentScore() % SPEED_UP_SCORE == 0) {
-            gameSpeed += GAME_SPEED_INCREMENT;
-            obstacleSpawnDelay = std::max(500, obstacleSpawnDelay - 100);  // Faster spawning, min 500ms
+        needsRedraw = true;
+        
+        // Animations follow the wall clock, not the frame count; headless
+        // runs step a steady 60 fps so their captures repeat
+        Uint32 now = SDL_GetTicks();
+        animationMs += options.headless ? 1000.0 / 60 : std::min<Uint32>(now - lastUpdateTicks, 100);
+        lastUpdateTicks = now;
+        
+        // Input, physics and scoring for every runner in one pass
+        uint32_t leadBefore = runners.leading();
+        runners.step(obstacles, distance, gameSpeed);
+        if (runners.leading() > leadBefore) {
+            // A speed-up takes effect before the world moves this frame, as in batch_env
+            scripts.signalNow(GAME_EVENT_NEW_LEAD, *this);
+        }
+        if (options.ghost) {
+            runTrace.push_back({distance, runners.runnerY(0), runners.isJumping(0)});
+        }
+        for (int runner = 0; runner < runners.humanCount(); runner++) {
+            uint8_t events = runners.eventsOf(runner);
+            if (events & RUNNER_LANDED) {
+                audio.play(SOUND_LAND);
+            }
+            if (events & RUNNER_SCORED) {
+                if (runner == 0) {
+                    scoreManager.incrementJumpScore();
+                    telemetry.record(TELEMETRY_SCORED_JUMP, scoreManager.getCurrentScore());
+                }
+                audio.play(SOUND_SCORE);
+                scripts.signal(GAME_EVENT_SCORED_JUMP);
+            }
         }
         
         // Update background
         background.update(gameSpeed);
         
         // Update obstacles
+        distance += gameSpeed;
         for (auto it = obstacles.begin(); it != obstacles.end();) {
+            float obstacleStartX = it->x;
+            int obstacleLeftStart = it->hitbox.x;
             it->update(gameSpeed);
             
-            // Check collision
-            if (SDL_HasIntersection(&player.hitbox, &it->hitbox)) {
+            // Sweep every runner along the whole frame, so fast thin obstacles cannot slip through
+            float impact = runners.sweep(obstacleLeftStart, it->hitbox.x, it->width, it->height);
+            if (impact >= 0.0f && runners.humansLeft() == 0) {
+                // The last player is out: freeze the obstacle at the moment of contact too
+                it->x = obstacleStartX - gameSpeed * impact;
+                it->updateHitbox();
+                
                 gameOver = true;
+                telemetry.record(TELEMETRY_DEATH, scoreManager.getCurrentScore(), static_cast<int>(it->x), it->type);
+                audio.play(SOUND_GAME_OVER);
+                leaderboard.submit(scoreManager.getCurrentScore());
+                leaderboard.requestTopScores();
                 // Don't update further - keep the obstacle that caused the collision
                 break;
             }
@@ -910,64 +3272,21 @@ public:
             }
         }
         
-        // Spawn new obstacles
-        unsigned int currentTime = SDL_GetTicks();
-        if (currentTime > lastObstacleTime + obstacleSpawnDelay) {
-            std::uniform_int_distribution<int> typeDist(0, OBSTACLE_TYPE_COUNT - 1);
-            ObstacleType type = static_cast<ObstacleType>(typeDist(rng));
-            
-            int width, height;
-            switch (type) {
-                case COFFEE_CUP:
-                    width = 30;
-                    height = 40;
-                    break;
-                case BRIEFCASE:
-                    width = 50;
-                    height = 30;
-                    break;
-                case FIRE_HYDRANT:
-                    width = 40;
-                    height = 60;
-                    break;
-                case TRASH_CAN:
-                    width = 45;
-                    height = 70;
-                    break;
-                case CAR:
-                    width = 100;
-                    height = 60;
-                    break;
-                case BICYCLE:
-                    width = 70;
-                    height = 50;
-                    break;
-                case PUDDLE:
-                    width = 80;
-                    height = 5;
-                    break;
-                case DOG:
-                    width = 60;
-                    height = 40;
-                    break;
-                default:
-                    width = 30;
-                    height = 50;
-                    break;
-            }
-            
-            // Add randomness to spawn delay
-            obstacles.emplace_back(SCREEN_WIDTH, width, height, type);
-            lastObstacleTime = currentTime;
-            
-            // Randomize next obstacle time
-            std::uniform_int_distribution<int> delayDist(-500, 500);
-            int nextDelay = obstacleSpawnDelay + delayDist(rng);
-            if (nextDelay < 500) nextDelay = 500;  // Minimum 500ms
+        for (int runner = 0; runner < static_cast<int>(humanViews.size()); runner++) {
+            humanViews[runner].follow(runners.runnerY(runner), runners.isJumping(runner), animationMs);
+        }
+        
+        // The course, its set pieces and the difficulty phases all run as scripts
+        if (bannerFrames > 0) {
+            bannerFrames--;
         }
+        scripts.tick(*this);
     }
     
     void render() {
+        // Draw at the logical resolution so the cost does not depend on the window size
+        SDL_SetRenderTarget(renderer, sceneTarget);
+        
         // Clear screen
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
         SDL_RenderClear(renderer);
@@ -975,12 +3294,22 @@ public:
         // Render background
         background.render(renderer);
         
-        // Render player
-        player.render(renderer);
+        // Render the crowd behind the players, then each player still in; player 1 on top
+        runners.render(renderer, sprites, playerFrames, animationMs);
+        for (int runner = static_cast<int>(humanViews.size()) - 1; runner >= 0; runner--) {
+            if (!runners.isRunning(runner) && !gameOver) {
+                continue;
+            }
+            if (runner > 0) {
+                SDL_SetTextureColorMod(sprites.texture(), 255, 190, 120);  // Tell the second player apart
+            }
+            humanViews[runner].render(renderer, sprites, playerFrames, characterTexture);
+            SDL_SetTextureColorMod(sprites.texture(), 255, 255, 255);
+        }
         
         // Render obstacles
         for (auto& obstacle : obstacles) {
-            obstacle.render(renderer);
+            obstacle.render(renderer, sprites, obstacleDecorations, animationMs);
         }
         
         // Render score
@@ -990,6 +3319,22 @@ public:
         std::string highScoreText = "High Score: " + std::to_string(scoreManager.getHighScore());
         textManager.renderText(renderer, highScoreText, 10, 40);
         
+        if (runners.humanCount() > 1) {
+            std::string secondText = "Player 2: " + std::to_string(runners.scoreOf(1));
+            textManager.renderText(renderer, secondText, 10, 70);
+        }
+        
+        if (showQualityReadout) {
+            char readout[64];
+            std::snprintf(readout, sizeof(readout), "Quality %d/%d  %.1f ms", quality.currentLevel(),
+                          QUALITY_LEVEL_COUNT - 1, quality.averageFrameMs());
+            textManager.renderText(renderer, readout, 10, SCREEN_HEIGHT - 30);
+        }
+        
+        if (bannerFrames > 0 && !bannerText.empty()) {
+            textManager.renderText(renderer, bannerText, SCREEN_WIDTH/2 - 10 * static_cast<int>(bannerText.size()) / 2, 80);
+        }
+        
         // Render game over text
         if (gameOver) {
             std::string gameOverText = "GAME OVER";
@@ -997,35 +3342,121 @@ public:
             
             std::string restartText = "Press SPACE to restart";
             textManager.renderText(renderer, restartText, SCREEN_WIDTH/2 - 120, SCREEN_HEIGHT/2 + 20);
+            
+            // Online top scores, whenever the last fetch has arrived
+            for (size_t i = 0; i < leaderboardLines.size(); i++) {
+                textManager.renderText(renderer, leaderboardLines[i], SCREEN_WIDTH - 220, 10 + static_cast<int>(i) * 30);
+            }
+        } else if (paused) {
+            std::string pausedText = "PAUSED";
+            textManager.renderText(renderer, pausedText, SCREEN_WIDTH/2 - 55, SCREEN_HEIGHT/2 - 20, true);
+            
+            std::string resumeText = "Press SPACE or P to resume";
+            textManager.renderText(renderer, resumeText, SCREEN_WIDTH/2 - 140, SCREEN_HEIGHT/2 + 20);
         }
         
+        // Scale the finished scene to the window in a single copy
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);  // Letterbox bars
+        SDL_RenderClear(renderer);
+        SDL_Rect destination = presentRect();
+        SDL_RenderCopy(renderer, sceneTarget, nullptr, &destination);
+        
         // Update screen
         SDL_RenderPresent(renderer);
+        needsRedraw = false;
     }
     
     void run() {
         const int FPS = 60;
         const int frameDelay = 1000 / FPS;
+        const int IDLE_WAIT_MS = 250;  // Still wakes often enough to show a leaderboard reply
         
         Uint32 frameStart;
         int frameTime;
         
+        double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+        
+        // Time spent awake versus in total, per loop state
+        Uint64 busyTicks[LOOP_STATE_COUNT] = {};
+        Uint64 totalTicks[LOOP_STATE_COUNT] = {};
+        
         while (isRunning) {
-            frameStart = SDL_GetTicks();
-            
-            handleEvents();
-            update();
-            render();
+            LoopState state = loopState();
+            Uint64 loopStart = SDL_GetPerformanceCounter();
+            Uint64 busy;
             
-            frameTime = SDL_GetTicks() - frameStart;
+            if (state == LOOP_PLAYING) {
+                frameStart = SDL_GetTicks();
+                
+                handleEvents();
+                update();
+                publishState();
+                render();
+                
+                busy = SDL_GetPerformanceCounter() - loopStart;
+                frameTime = SDL_GetTicks() - frameStart;
+                
+                // Shed or restore detail to hold the frame rate
+                if (quality.observe(busy / ticksPerMs)) {
+                    applyQuality();
+                }
+                
+                if (frameDelay > frameTime) {
+                    SDL_Delay(frameDelay - frameTime);
+                }
+            } else {
+                // Nothing animates: block on the event queue instead of ticking at 60 fps
+                waitForEvents(IDLE_WAIT_MS);
+                Uint64 awake = SDL_GetPerformanceCounter();
+                update();
+                publishState();
+                if (needsRedraw && !hidden) {
+                    render();
+                }
+                busy = SDL_GetPerformanceCounter() - awake;
+            }
             
-            if (frameDelay > frameTime) {
-                SDL_Delay(frameDelay - frameTime);
+            busyTicks[state] += busy;
+            totalTicks[state] += SDL_GetPerformanceCounter() - loopStart;
+        }
+        
+        reportCpuUsage(busyTicks, totalTicks);
+    }
+    
+    // Main-thread share of each state's wall time spent working rather than sleeping
+    static void reportCpuUsage(const Uint64 busyTicks[], const Uint64 totalTicks[]) {
+        double ticksPerSecond = static_cast<double>(SDL_GetPerformanceFrequency());
+        std::cout << "Main loop CPU use by state:" << std::endl;
+        for (int state = 0; state < LOOP_STATE_COUNT; state++) {
+            if (totalTicks[state] == 0) {
+                continue;
             }
+            std::printf("  %-10s %8.1f s  %5.1f%% busy\n", LOOP_STATE_NAMES[state], totalTicks[state] / ticksPerSecond,
+                        100.0 * busyTicks[state] / totalTicks[state]);
         }
     }
     
     void clean() {
+        telemetry.stop();
+        stateExport.stop();
+        audio.clean();
+        leaderboard.stop();
+        
+        // Background strips and sprites belong to the renderer, release them first
+        background.clean();
+        sprites.clean();
+        
+        if (characterTexture) {
+            SDL_DestroyTexture(characterTexture);
+            characterTexture = nullptr;
+        }
+        
+        if (sceneTarget) {
+            SDL_DestroyTexture(sceneTarget);
+            sceneTarget = nullptr;
+        }
+        
         if (renderer) {
             SDL_DestroyRenderer(renderer);
             renderer = nullptr;
@@ -1035,6 +3466,11 @@ public:
             SDL_DestroyWindow(window);
             window = nullptr;
         }
+        
+        if (headlessSurface) {
+            SDL_FreeSurface(headlessSurface);
+            headlessSurface = nullptr;
+        }
         IMG_Quit();
         SDL_Quit();
     }
@@ -1044,8 +3480,383 @@ public:
     }
 };
 
+// Drives seeded headless games through scripted input, checks selected
+// frames against stored golden images and holds each scenario to a
+// frame-time budget. Run with --golden-check; --golden-record rewrites the
+// golden images after an intended visual change.
+class RegressionHarness {
+private:
+    struct Scenario {
+        std::string name;
+        uint64_t seed;
+        int64_t startDistance;
+        int frames;
+        std::vector<int> jumpFrames;
+        std::vector<int> captureFrames;
+        double frameBudgetMs;  // 95th percentile of update + render
+        bool audio;            // Mix sound on SDL's dummy audio driver and check what was played
+        bool deadLeaderboard;  // Point the leaderboard at a server that never answers
+        int bots;              // Computer runners alongside the player
+    };
+
+    static const int CHANNEL_TOLERANCE = 8;        // Per colour channel, out of 255
+    static constexpr double MAX_MISMATCH = 0.001;  // Fraction of pixels allowed outside the tolerance
+    static const uint64_t LOCKSTEP_SEED = 15;      // A course the lockstep policy survives for a long while
+    static const int LOCKSTEP_SPEED_UPS = 4;
+    static const int LOCKSTEP_FRAMES = 25000;      // Give up on reaching the speed-ups after this many
+    static const int LOCKSTEP_APEX_FRAMES = 20;    // Roughly when a jump peaks
+
+    bool recording;
+
+    static std::vector<Scenario> scenarios() {
+        std::vector<int> everyFortyFrames;
+        for (int frame = 10; frame < 600; frame += 40) {
+            everyFortyFrames.push_back(frame);
+        }
+        return {
+            {"opening", 1, 0, 90, {}, {0, 89}, 8.0, false, false, 0},
+            {"jump_arc", 1, 0, 60, {5}, {15, 25}, 8.0, false, false, 0},
+            {"crash", 2, 0, 400, {}, {399}, 8.0, false, false, 0},
+            {"mid_course", 3, 50000, 30, {}, {0, 29}, 8.0, false, false, 0},
+            {"long_run", 4, 0, 600, everyFortyFrames, {599}, 8.0, false, false, 0},
+            // Every sound reaches the mixer, and each speed-up sounds exactly once
+            {"audio", 4, 0, 600, everyFortyFrames, {}, 8.0, true, false, 0},
+            // Crashes and restarts against a server that accepts but never replies
+            {"dead_leaderboard", 2, 0, 900, {400, 700}, {}, 8.0, false, true, 0},
+            // A few hundred bots must fit in the same frame budget as the player alone
+            {"crowd", 4, 0, 600, everyFortyFrames, {}, 8.0, false, false, 500}
+        };
+    }
+
+    static bool contains(const std::vector<int>& frames, int frame) {
+        return std::find(frames.begin(), frames.end(), frame) != frames.end();
+    }
+
+    bool checkFrame(SDL_Surface* frame, const std::string& goldenPath) {
+        if (recording) {
+            if (SDL_SaveBMP(frame, goldenPath.c_str()) != 0) {
+                std::cerr << "  could not write " << goldenPath << ": " << SDL_GetError() << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        SDL_Surface* loaded = SDL_LoadBMP(goldenPath.c_str());
+        if (!loaded) {
+            std::cerr << "  missing golden image " << goldenPath << " (run with --golden-record)" << std::endl;
+            return false;
+        }
+        SDL_Surface* golden = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(loaded);
+        if (!golden || golden->w != frame->w || golden->h != frame->h) {
+            std::cerr << "  golden image " << goldenPath << " has the wrong size" << std::endl;
+            SDL_FreeSurface(golden);
+            return false;
+        }
+
+        long mismatched = 0;
+        for (int row = 0; row < frame->h; row++) {
+            const Uint8* actual = static_cast<const Uint8*>(frame->pixels) + row * frame->pitch;
+            const Uint8* expected = static_cast<const Uint8*>(golden->pixels) + row * golden->pitch;
+            for (int column = 0; column < frame->w; column++) {
+                for (int channel = 0; channel < 3; channel++) {  // Alpha is irrelevant on screen
+                    if (std::abs(actual[column * 4 + channel] - expected[column * 4 + channel]) > CHANNEL_TOLERANCE) {
+                        mismatched++;
+                        break;
+                    }
+                }
+            }
+        }
+        SDL_FreeSurface(golden);
+
+        double fraction = static_cast<double>(mismatched) / (frame->w * frame->h);
+        if (fraction > MAX_MISMATCH) {
+            std::string actualPath = goldenPath.substr(0, goldenPath.size() - 4) + "_actual.bmp";
+            SDL_SaveBMP(frame, actualPath.c_str());
+            std::cerr << "  " << goldenPath << ": " << mismatched << " pixels differ, see " << actualPath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool checkAudio(const AudioMixer& mixer, int speedUps) {
+        if (!mixer.isOpen()) {
+            std::cerr << "  the dummy audio device could not be opened" << std::endl;
+            return false;
+        }
+        if (mixer.postedCount(SOUND_SPEED_UP) != static_cast<unsigned int>(speedUps)) {
+            std::cerr << "  " << mixer.postedCount(SOUND_SPEED_UP) << " speed-up sounds for " << speedUps
+                      << " speed-ups" << std::endl;
+            return false;
+        }
+        if (mixer.postedCount(SOUND_JUMP) == 0) {
+            std::cerr << "  no jump sounds" << std::endl;
+            return false;
+        }
+
+        // The dummy driver runs the callback in real time; give it a moment to drain the queue
+        for (int waited = 0; waited < 1000 && mixer.startedCount() < mixer.postedTotal(); waited += 10) {
+            SDL_Delay(10);
+        }
+        if (mixer.startedCount() != mixer.postedTotal()) {
+            std::cerr << "  " << mixer.startedCount() << " of " << mixer.postedTotal() << " sounds were mixed" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool playScenario(Game& game, const Scenario& scenario) {
+        bool passed = true;
+        std::vector<double> frameTimes;
+        double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+        for (int frame = 0; frame < scenario.frames; frame++) {
+            if (contains(scenario.jumpFrames, frame)) {
+                game.pressJump();
+            }
+
+            Uint64 start = SDL_GetPerformanceCounter();
+            game.update();
+            game.render();
+            frameTimes.push_back((SDL_GetPerformanceCounter() - start) / ticksPerMs);
+
+            if (contains(scenario.captureFrames, frame)) {
+                std::string goldenPath = GOLDEN_DIRECTORY + scenario.name + "_" + std::to_string(frame) + ".bmp";
+                passed = checkFrame(game.offscreenFrame(), goldenPath) && passed;
+            }
+        }
+
+        if (scenario.audio) {
+            passed = checkAudio(game.sound(), game.speedUpCount()) && passed;
+        }
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+        double p95 = frameTimes[frameTimes.size() * 95 / 100];
+        std::cout << "  p95 frame time " << p95 << " ms (budget " << scenario.frameBudgetMs << " ms)" << std::endl;
+        if (p95 > scenario.frameBudgetMs) {
+            std::cerr << "  over the frame-time budget" << std::endl;
+            passed = false;
+        }
+        return passed;
+    }
+
+    // Steps the game and batch_env side by side with the same jumps, which
+    // batch_env's observation picks; speed, distance and height must agree
+    // on every frame
+    bool playLockstep(Game& game, BatchEnv* env, decltype(&batch_env_reset) reset, decltype(&batch_env_step) step) {
+        uint64_t seed = LOCKSTEP_SEED;
+        float observation[BATCH_ENV_OBSERVATION_SIZE];
+        float reward;
+        uint8_t done = 0;
+        int64_t envDistance = 0;
+        reset(env, &seed, observation);
+
+        for (int frame = 0; frame < LOCKSTEP_FRAMES && game.speedUpCount() < LOCKSTEP_SPEED_UPS; frame++) {
+            // Jump from the ground once the nearest obstacle's middle is within reach of the jump's peak
+            float gap = observation[3] + observation[4] / 2 - (PLAYER_X + PLAYER_WIDTH / 2.0f);
+            uint8_t jump = observation[1] == 0.0f && gap > 0.0f && gap <= LOCKSTEP_APEX_FRAMES * observation[2];
+            if (jump) {
+                game.pressJump();
+            }
+            game.update();
+            step(env, &jump, observation, &reward, &done);
+            envDistance += static_cast<int64_t>(observation[2]);
+
+            if (done || game.isGameOver()) {
+                if (done && game.isGameOver()) {
+                    std::cerr << "  both crashed at frame " << frame << " after " << game.speedUpCount()
+                              << " speed-ups; the course or the policy needs changing" << std::endl;
+                } else {
+                    std::cerr << "  frame " << frame << ": only " << (done ? "batch_env" : "the game") << " crashed" << std::endl;
+                }
+                return false;
+            }
+            if (game.currentSpeed() != static_cast<int>(observation[2]) || game.scriptDistance() != envDistance ||
+                std::abs(game.playerY() - observation[0]) > 0.01f) {
+                std::cerr << "  frame " << frame << ": speed " << game.currentSpeed() << ", distance " << game.scriptDistance()
+                          << ", height " << game.playerY() << " against batch_env's " << observation[2] << ", "
+                          << envDistance << ", " << observation[0] << std::endl;
+                return false;
+            }
+        }
+
+        if (game.speedUpCount() < LOCKSTEP_SPEED_UPS) {
+            std::cerr << "  only " << game.speedUpCount() << " speed-ups in " << LOCKSTEP_FRAMES << " frames" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool checkLockstep() {
+        void* library = SDL_LoadObject(BATCH_ENV_LIBRARY.c_str());
+        if (!library) {
+            std::cerr << "  could not load " << BATCH_ENV_LIBRARY << " (build batch_env first): " << SDL_GetError() << std::endl;
+            return false;
+        }
+        auto create = reinterpret_cast<decltype(&batch_env_create)>(SDL_LoadFunction(library, "batch_env_create"));
+        auto destroy = reinterpret_cast<decltype(&batch_env_destroy)>(SDL_LoadFunction(library, "batch_env_destroy"));
+        auto reset = reinterpret_cast<decltype(&batch_env_reset)>(SDL_LoadFunction(library, "batch_env_reset"));
+        auto step = reinterpret_cast<decltype(&batch_env_step)>(SDL_LoadFunction(library, "batch_env_step"));
+
+        bool passed = false;
+        if (create && destroy && reset && step) {
+            GameOptions options;
+            options.headless = true;
+            options.telemetry = false;
+            options.audio = false;
+            options.persistHighScore = false;
+            options.seed = LOCKSTEP_SEED;
+            Game game(options);
+            if (game.initialize()) {
+                BatchEnv* env = create(1);
+                passed = playLockstep(game, env, reset, step);
+                destroy(env);
+            } else {
+                std::cerr << "  game could not initialize" << std::endl;
+            }
+        } else {
+            std::cerr << "  " << BATCH_ENV_LIBRARY << " is missing batch_env functions" << std::endl;
+        }
+        SDL_UnloadObject(library);
+        return passed;
+    }
+
+    bool runScenario(const Scenario& scenario) {
+        GameOptions options;
+        options.headless = true;
+        options.telemetry = false;
+        options.audio = false;
+        options.persistHighScore = false;
+        options.seed = scenario.seed;
+        options.startDistance = scenario.startDistance;
+        options.bots = scenario.bots;
+        if (scenario.audio) {
+            SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+            options.audio = true;
+        }
+        if (scenario.deadLeaderboard && !NetSocket::startup()) {
+            std::cerr << "  networking could not initialize" << std::endl;
+            return false;
+        }
+
+        bool passed = false;
+        {
+            // A listening socket nobody accepts from: connections succeed, replies never come
+            NetSocket deadServer;
+            if (scenario.deadLeaderboard) {
+                if (deadServer.listenOn(0)) {
+                    options.leaderboardHost = "127.0.0.1";
+                    options.leaderboardPort = deadServer.localPort();
+                } else {
+                    std::cerr << "  could not open the stand-in server socket" << std::endl;
+                }
+            }
+
+            if (!scenario.deadLeaderboard || !options.leaderboardHost.empty()) {
+                Game game(options);
+                if (game.initialize()) {
+                    passed = playScenario(game, scenario);
+                } else {
+                    std::cerr << "  game could not initialize" << std::endl;
+                }
+            }
+        }
+
+        // The game and the stand-in socket are gone; release our hold on networking
+        if (scenario.deadLeaderboard) {
+            NetSocket::shutdown();
+        }
+        return passed;
+    }
+
+public:
+    explicit RegressionHarness(bool recordGoldens) : recording(recordGoldens) {}
+
+    // Returns the process exit code
+    int run() {
+        int failures = 0;
+        for (const auto& scenario : scenarios()) {
+            std::cout << scenario.name << std::endl;
+            if (!runScenario(scenario)) {
+                failures++;
+                std::cout << "  FAILED" << std::endl;
+            }
+        }
+        size_t checked = scenarios().size();
+        if (!recording) {
+            // Nothing to record: the game is held to batch_env rather than to golden images
+            std::cout << "batch_env_lockstep" << std::endl;
+            if (!checkLockstep()) {
+                failures++;
+                std::cout << "  FAILED" << std::endl;
+            }
+            checked++;
+        }
+        std::cout << (recording ? "Recorded" : "Checked") << " " << checked << " scenarios, "
+                  << failures << " failed" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+};
+
 int main(int argc, char* args[]) {
-    Game game;
+    GameOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--golden-check" || arg == "--golden-record") {
+            RegressionHarness harness(arg == "--golden-record");
+            return harness.run();
+        } else if (arg == "--no-telemetry") {
+            options.telemetry = false;
+        } else if (arg == "--no-audio") {
+            options.audio = false;
+        } else if (arg == "--audio-buffer" && i + 1 < argc) {
+            options.audioBufferSamples = std::max(64, std::min(8192, std::atoi(args[++i])));
+        } else if (arg == "--resizable") {
+            options.resizable = true;
+        } else if (arg == "--fullscreen") {
+            options.fullscreen = true;
+        } else if (arg == "--scale" && i + 1 < argc) {
+            std::string mode = args[++i];
+            options.scaling = mode == "linear" ? SCALE_LINEAR : SCALE_INTEGER;
+        } else if (arg == "--leaderboard" && i + 1 < argc) {
+            std::string server = args[++i];
+            size_t colon = server.rfind(':');
+            options.leaderboardHost = server.substr(0, colon);
+            if (colon != std::string::npos) {
+                options.leaderboardPort = std::atoi(server.c_str() + colon + 1);
+            }
+        } else if (arg == "--name" && i + 1 < argc) {
+            // Scores are sent one "name score" per line
+            std::string name = args[++i];
+            for (char& c : name) {
+                if (std::isspace(static_cast<unsigned char>(c))) {
+                    c = '_';
+                }
+            }
+            if (!name.empty()) {
+                options.playerName = name;
+            }
+        } else if (arg == "--bots" && i + 1 < argc) {
+            options.bots = std::max(0, std::min(RunnerCrowd::MAX_RUNNERS - 3, std::atoi(args[++i])));
+        } else if (arg == "--split-keys") {
+            options.splitKeys = true;
+        } else if (arg == "--ghost") {
+            options.ghost = true;
+        } else if (arg == "--export-state") {
+            options.exportState = true;
+        } else if (arg == "--quality" && i + 1 < argc) {
+            options.quality = std::max(0, std::min(QUALITY_LEVEL_COUNT - 1, std::atoi(args[++i])));
+        } else if (arg == "--course" && i + 1 < argc) {
+            options.coursePath = args[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::strtoull(args[++i], nullptr, 10);
+        } else if (arg == "--start-distance" && i + 1 < argc) {
+            options.startDistance = std::max(0LL, std::strtoll(args[++i], nullptr, 10));
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+        }
+    }
+    
+    Game game(options);
     
     if (game.initialize()) {
         game.run();
@@ -0,0 +1,263 @@
+#ifndef NET_SOCKET_H
+#define NET_SOCKET_H
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET NativeSocket;
+const NativeSocket INVALID_NATIVE_SOCKET = INVALID_SOCKET;
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+typedef int NativeSocket;
+const NativeSocket INVALID_NATIVE_SOCKET = -1;
+#endif
+
+// Writing to a connection the peer has closed raises SIGPIPE on POSIX,
+// which kills the process; ask for EPIPE instead
+#ifdef MSG_NOSIGNAL
+const int NET_SEND_FLAGS = MSG_NOSIGNAL;  // Linux
+#else
+const int NET_SEND_FLAGS = 0;  // Windows has no SIGPIPE; macOS uses SO_NOSIGPIPE per socket
+#endif
+
+// Minimal blocking TCP socket with timeouts, shared by the leaderboard
+// client and the stand-in leaderboard server. Link ws2_32 on Windows.
+class NetSocket {
+private:
+    NativeSocket handle;
+
+    bool setBlocking(bool blocking) {
+#ifdef _WIN32
+        u_long nonBlocking = blocking ? 0 : 1;
+        return ioctlsocket(handle, FIONBIO, &nonBlocking) == 0;
+#else
+        int flags = fcntl(handle, F_GETFL, 0);
+        flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+        return fcntl(handle, F_SETFL, flags) == 0;
+#endif
+    }
+
+    void setTimeouts(int timeoutMs) {
+#ifdef _WIN32
+        DWORD timeout = static_cast<DWORD>(timeoutMs);
+#else
+        timeval timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+#endif
+        setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+    }
+
+    void suppressSigpipe() {
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    }
+
+public:
+    NetSocket() : handle(INVALID_NATIVE_SOCKET) {}
+    explicit NetSocket(NativeSocket accepted) : handle(accepted) {}
+
+    NetSocket(const NetSocket&) = delete;
+    NetSocket& operator=(const NetSocket&) = delete;
+
+    NetSocket(NetSocket&& other) : handle(other.handle) {
+        other.handle = INVALID_NATIVE_SOCKET;
+    }
+
+    NetSocket& operator=(NetSocket&& other) {
+        if (this != &other) {
+            close();
+            handle = other.handle;
+            other.handle = INVALID_NATIVE_SOCKET;
+        }
+        return *this;
+    }
+
+    // Once per process before any socket is used
+    static bool startup() {
+#ifdef _WIN32
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+        return true;
+#endif
+    }
+
+    static void shutdown() {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    bool isOpen() const {
+        return handle != INVALID_NATIVE_SOCKET;
+    }
+
+    // Connects with a bounded wait; every later send and receive also times out
+    bool connectTo(const std::string& host, int port, int timeoutMs) {
+        close();
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* address = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &address) != 0 || !address) {
+            return false;
+        }
+
+        handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        bool connected = false;
+        if (isOpen() && setBlocking(false)) {
+            suppressSigpipe();
+            connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen));
+            fd_set writable, failed;  // Windows reports a refused connect as an exception
+            FD_ZERO(&writable);
+            FD_ZERO(&failed);
+            FD_SET(handle, &writable);
+            FD_SET(handle, &failed);
+            timeval timeout;
+            timeout.tv_sec = timeoutMs / 1000;
+            timeout.tv_usec = (timeoutMs % 1000) * 1000;
+            if (select(static_cast<int>(handle) + 1, nullptr, &writable, &failed, &timeout) > 0 &&
+                FD_ISSET(handle, &writable)) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(handle, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length);
+                connected = error == 0;
+            }
+        }
+        freeaddrinfo(address);
+
+        if (!connected || !setBlocking(true)) {
+            close();
+            return false;
+        }
+        setTimeouts(timeoutMs);
+        return true;
+    }
+
+    // Listens on the loopback interface; port 0 picks a free one
+    bool listenOn(int port) {
+        close();
+        handle = socket(AF_INET, SOCK_STREAM, 0);
+        if (!isOpen()) {
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<unsigned short>(port));
+        if (bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(handle, 16) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    int localPort() const {
+        sockaddr_in address;
+        socklen_t length = sizeof(address);
+        if (getsockname(handle, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return 0;
+        }
+        return ntohs(address.sin_port);
+    }
+
+    NetSocket accept(int timeoutMs) {
+        NetSocket client(::accept(handle, nullptr, nullptr));
+        if (client.isOpen()) {
+            client.suppressSigpipe();
+            client.setTimeouts(timeoutMs);
+        }
+        return client;
+    }
+
+    bool sendAll(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            int result = send(handle, data.data() + sent, static_cast<int>(data.size() - sent), NET_SEND_FLAGS);
+            if (result <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(result);
+        }
+        return true;
+    }
+
+    // Reads until the peer closes the connection, a timeout, or limit bytes
+    bool receiveAll(std::string& data, size_t limit) {
+        char buffer[1024];
+        while (data.size() < limit) {
+            int result = recv(handle, buffer, sizeof(buffer), 0);
+            if (result == 0) {
+                return true;
+            }
+            if (result < 0) {
+                return false;
+            }
+            data.append(buffer, static_cast<size_t>(result));
+        }
+        return true;
+    }
+
+    // Reads one HTTP request: headers plus Content-Length bytes of body
+    bool receiveRequest(std::string& data, size_t limit) {
+        char buffer[1024];
+        while (data.size() < limit) {
+            size_t headerEnd = data.find("\r\n\r\n");
+            if (headerEnd != std::string::npos) {
+                size_t contentLength = 0;
+                size_t field = data.find("Content-Length:");
+                if (field != std::string::npos && field < headerEnd) {
+                    contentLength = static_cast<size_t>(std::strtoul(data.c_str() + field + 15, nullptr, 10));
+                }
+                if (data.size() >= headerEnd + 4 + contentLength) {
+                    return true;
+                }
+            }
+            int result = recv(handle, buffer, sizeof(buffer), 0);
+            if (result <= 0) {
+                return false;
+            }
+            data.append(buffer, static_cast<size_t>(result));
+        }
+        return false;
+    }
+
+    void close() {
+        if (isOpen()) {
+#ifdef _WIN32
+            closesocket(handle);
+#else
+            ::close(handle);
+#endif
+            handle = INVALID_NATIVE_SOCKET;
+        }
+    }
+
+    ~NetSocket() {
+        close();
+    }
+};
+
+#endif // NET_SOCKET_H
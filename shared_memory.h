@@ -0,0 +1,151 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// A named shared-memory region: POSIX shm_open on Linux and macOS (link
+// with -lrt on older glibc), a pagefile-backed file mapping on Windows.
+// The creator owns the name and removes it on close; others attach to it
+// read-only.
+class SharedMemory {
+private:
+    unsigned char* bytes;
+    size_t length;
+    std::string name;
+    bool owner;
+#ifdef _WIN32
+    HANDLE mappingHandle;
+#endif
+
+    bool map(bool writable) {
+#ifdef _WIN32
+        void* view = MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length);
+#else
+        int fd = shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        void* view = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // The mapping keeps its own reference
+        if (view == MAP_FAILED) {
+            view = nullptr;
+        }
+#endif
+        bytes = static_cast<unsigned char*>(view);
+        return bytes != nullptr;
+    }
+
+public:
+    SharedMemory() : bytes(nullptr), length(0), owner(false)
+#ifdef _WIN32
+        , mappingHandle(nullptr)
+#endif
+    {}
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    // Creates (or takes over) the region, zero-filled on first creation
+    bool create(const std::string& regionName, size_t size) {
+        close();
+        name = regionName;
+        length = size;
+#ifdef _WIN32
+        mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                           0, static_cast<DWORD>(size), name.c_str());
+        if (!mappingHandle) {
+            return false;
+        }
+#else
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        bool sized = ftruncate(fd, static_cast<off_t>(size)) == 0;
+        ::close(fd);
+        if (!sized) {
+            shm_unlink(name.c_str());
+            return false;
+        }
+#endif
+        owner = true;
+        if (!map(true)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Attaches read-only to a region someone else created
+    bool openExisting(const std::string& regionName, size_t size) {
+        close();
+        name = regionName;
+        length = size;
+#ifdef _WIN32
+        mappingHandle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+        if (!mappingHandle) {
+            return false;
+        }
+#endif
+        if (!map(false)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (bytes) {
+            UnmapViewOfFile(bytes);
+        }
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+            mappingHandle = nullptr;
+        }
+#else
+        if (bytes) {
+            munmap(bytes, length);
+        }
+        if (owner) {
+            shm_unlink(name.c_str());
+        }
+#endif
+        bytes = nullptr;
+        length = 0;
+        owner = false;
+    }
+
+    unsigned char* data() const {
+        return bytes;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    bool isOpen() const {
+        return bytes != nullptr;
+    }
+
+    ~SharedMemory() {
+        close();
+    }
+};
+
+#endif // SHARED_MEMORY_H
@@ -0,0 +1,63 @@
+#ifndef SPRITE_ANIMATIONS_H
+#define SPRITE_ANIMATIONS_H
+
+#include "game_constants.h"
+
+// Animation data for everything drawn from the sprite atlas. Frames are
+// baked into the atlas once; a clip only says which of an owner's frames
+// play, in what order and how fast, so playback is a table lookup and a
+// source rect, never a branch in the drawing code.
+
+// A run of consecutive frames played at a fixed rate
+struct AnimationClip {
+    int firstFrame;        // Among the owner's frames
+    int frameCount;
+    float framesPerSecond;
+    bool loops;            // Otherwise holds the last frame
+};
+
+// Frame of a clip elapsedMs after it started
+inline int clipFrame(const AnimationClip& clip, double elapsedMs) {
+    int step = static_cast<int>(elapsedMs * clip.framesPerSecond / 1000.0);
+    if (step < 0) {
+        step = 0;
+    }
+    step = clip.loops ? step % clip.frameCount : (step < clip.frameCount ? step : clip.frameCount - 1);
+    return clip.firstFrame + step;
+}
+
+// One baked pose of the player, drawn over the character image. Leg
+// tops are measured down from the top of the hitbox.
+struct PlayerPose {
+    int frontLegTop;
+    int frontLegLength;
+    int backLegTop;
+    int backLegLength;
+    bool briefcase;
+};
+
+const PlayerPose PLAYER_POSES[] = {
+    {50, 30, 60, 20, true},   // Running, front leg forward
+    {60, 20, 50, 30, true},   // Running, back leg forward
+    {60, 20, 60, 15, true},   // Jumping
+    {60, 20, 60, 15, false}   // Jumping, briefcase swung behind
+};
+const int PLAYER_POSE_COUNT = sizeof(PLAYER_POSES) / sizeof(PLAYER_POSES[0]);
+
+const AnimationClip PLAYER_RUN_CLIP = {0, 2, 12.0f, true};
+const AnimationClip PLAYER_JUMP_CLIP = {2, 2, 12.0f, true};
+
+// Idle animation of each obstacle type. Every frame is baked twice, with
+// and without decorations, so the quality scaler still picks per frame.
+const AnimationClip OBSTACLE_CLIPS[OBSTACLE_TYPE_COUNT] = {
+    {0, 2, 4.0f, true},   // COFFEE_CUP, steaming
+    {0, 1, 1.0f, true},   // BRIEFCASE
+    {0, 1, 1.0f, true},   // FIRE_HYDRANT
+    {0, 1, 1.0f, true},   // TRASH_CAN
+    {0, 1, 1.0f, true},   // CAR
+    {0, 1, 1.0f, true},   // BICYCLE
+    {0, 1, 1.0f, true},   // PUDDLE
+    {0, 2, 8.0f, true}    // DOG, trotting
+};
+
+#endif // SPRITE_ANIMATIONS_H
@@ -0,0 +1,97 @@
+#ifndef STATE_EXPORT_FORMAT_H
+#define STATE_EXPORT_FORMAT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Layout of the shared-memory region the game publishes its state into
+// with --export-state, for overlays, bots and analysis tools. The region
+// is one StateExportHeader followed by a ring of STATE_EXPORT_SLOTS
+// slots. Frame n is written to slot n % STATE_EXPORT_SLOTS under that
+// slot's sequence lock, then header.latestFrame is set to n.
+//
+// The region is named STATE_EXPORT_NAME: POSIX shared memory
+// (/dev/shm/city_runner_state on Linux) or a named file mapping on
+// Windows. Readers map it read-only and never make a syscall per frame;
+// readStateSnapshot() below is the whole read protocol.
+
+const char STATE_EXPORT_MAGIC[4] = {'C', 'R', 'S', 'T'};
+const uint32_t STATE_EXPORT_VERSION = 1;
+const uint32_t STATE_EXPORT_SLOTS = 8;
+const uint32_t STATE_EXPORT_MAX_OBSTACLES = 8;  // Nearest ones first, none behind the player
+
+#ifdef _WIN32
+const char STATE_EXPORT_NAME[] = "Local\\city_runner_state";
+#else
+const char STATE_EXPORT_NAME[] = "/city_runner_state";
+#endif
+
+struct StateExportObstacle {
+    float x;           // Left edge on screen
+    float width;
+    float height;      // Obstacles stand on GROUND_LEVEL
+    uint32_t type;     // ObstacleType
+};
+
+struct StateExportSnapshot {
+    uint64_t frame;
+    int64_t distance;  // Course distance scrolled this run
+    float playerX;     // Top-left of the player hitbox
+    float playerY;
+    float playerVelocity;
+    uint32_t score;
+    int32_t gameSpeed;
+    uint8_t gameOver;
+    uint8_t jumping;
+    uint8_t paused;
+    uint8_t reserved;
+    uint32_t obstacleCount;
+    uint32_t reserved2;
+    StateExportObstacle obstacles[STATE_EXPORT_MAX_OBSTACLES];
+};
+
+struct StateExportSlot {
+    std::atomic<uint32_t> sequence;  // Odd while the writer is inside the slot
+    uint32_t reserved;
+    StateExportSnapshot snapshot;
+    uint64_t padding;                // Keeps slots on 64-byte boundaries
+};
+
+struct StateExportHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;                 // sizeof(StateExportSlot)
+    std::atomic<uint64_t> latestFrame; // Newest complete frame; 0 until the first one
+    uint64_t reserved[5];
+};
+
+struct StateExportRegion {
+    StateExportHeader header;
+    StateExportSlot slots[STATE_EXPORT_SLOTS];
+};
+
+static_assert(sizeof(StateExportSnapshot) == 176, "StateExportSnapshot must stay 176 bytes");
+static_assert(sizeof(StateExportSlot) == 192, "StateExportSlot must stay 192 bytes");
+static_assert(sizeof(StateExportHeader) == 64, "StateExportHeader must stay 64 bytes");
+
+// Copies the newest snapshot out of the region. Returns false when there
+// is none yet or the writer lapped the reader; just try again next time.
+inline bool readStateSnapshot(const StateExportRegion* region, StateExportSnapshot& out) {
+    uint64_t frame = region->header.latestFrame.load(std::memory_order_acquire);
+    if (frame == 0) {
+        return false;
+    }
+    const StateExportSlot& slot = region->slots[frame % STATE_EXPORT_SLOTS];
+    uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    std::memcpy(&out, &slot.snapshot, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = slot.sequence.load(std::memory_order_relaxed);
+    return before == after && out.frame == frame;
+}
+
+#endif // STATE_EXPORT_FORMAT_H
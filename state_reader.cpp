@@ -0,0 +1,76 @@
+// Attaches to the state a running game publishes with --export-state
+// and prints it. Usage: state_reader [--once] [--interval-ms 100]
+//
+// Doubles as the reference reader for the format: the whole protocol is
+// readStateSnapshot() from state_export_format.h, run against a read-only
+// mapping, so polling costs a memcpy and no syscalls.
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "shared_memory.h"
+#include "state_export_format.h"
+
+void sleepMs(int milliseconds) {
+#ifdef _WIN32
+    Sleep(static_cast<DWORD>(milliseconds));
+#else
+    usleep(static_cast<useconds_t>(milliseconds) * 1000);
+#endif
+}
+
+void printSnapshot(const StateExportSnapshot& snapshot) {
+    std::printf("frame %llu  distance %lld  score %u  speed %d%s%s%s\n",
+                static_cast<unsigned long long>(snapshot.frame), static_cast<long long>(snapshot.distance),
+                snapshot.score, snapshot.gameSpeed, snapshot.jumping ? "  jumping" : "",
+                snapshot.paused ? "  paused" : "", snapshot.gameOver ? "  game over" : "");
+    std::printf("  player (%.0f, %.0f) velocity %.2f\n", snapshot.playerX, snapshot.playerY, snapshot.playerVelocity);
+    for (uint32_t i = 0; i < snapshot.obstacleCount && i < STATE_EXPORT_MAX_OBSTACLES; i++) {
+        const StateExportObstacle& obstacle = snapshot.obstacles[i];
+        std::printf("  obstacle type %u at %.0f, %.0fx%.0f\n", obstacle.type, obstacle.x, obstacle.width, obstacle.height);
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char* args[]) {
+    bool once = false;
+    int intervalMs = 100;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = args[i];
+        if (arg == "--once") {
+            once = true;
+        } else if (arg == "--interval-ms" && i + 1 < argc) {
+            intervalMs = std::atoi(args[++i]);
+        } else {
+            std::cerr << "Usage: " << args[0] << " [--once] [--interval-ms N]" << std::endl;
+            return 1;
+        }
+    }
+
+    SharedMemory memory;
+    if (!memory.openExisting(STATE_EXPORT_NAME, sizeof(StateExportRegion))) {
+        std::cerr << "No game is exporting state (start it with --export-state)" << std::endl;
+        return 1;
+    }
+    const StateExportRegion* region = reinterpret_cast<const StateExportRegion*>(memory.data());
+    if (std::memcmp(region->header.magic, STATE_EXPORT_MAGIC, sizeof(region->header.magic)) != 0 ||
+        region->header.version != STATE_EXPORT_VERSION || region->header.slotSize != sizeof(StateExportSlot)) {
+        std::cerr << "Unsupported state export region" << std::endl;
+        return 1;
+    }
+
+    uint64_t lastFrame = 0;
+    while (true) {
+        StateExportSnapshot snapshot;
+        if (readStateSnapshot(region, snapshot) && snapshot.frame != lastFrame) {
+            lastFrame = snapshot.frame;
+            printSnapshot(snapshot);
+            if (once) {
+                return 0;
+            }
+        }
+        sleepMs(once ? 1 : intervalMs);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef SWEPT_COLLISION_H
+#define SWEPT_COLLISION_H
+
+#include <algorithm>
+#include <limits>
+
+#include "game_constants.h"
+
+// Continuous collision between the player and an obstacle over one frame.
+// Both hitboxes are taken at their start and end of frame positions and
+// assumed to move linearly in between, which is exactly what the one-step
+// integration does. Overlap is strict on both axes like SDL_HasIntersection,
+// so the old end-of-frame test is a special case (t = 1) and boxes that
+// only touch never collide. Shared by the game and the batch environment;
+// the SIMD path there mirrors these operations one for one.
+
+// Interval of t over which a box moving by `move` strictly overlaps a static one
+inline void sweptAxisInterval(float movingMin, float movingSize, float move, float staticMin, float staticSize,
+                              float& enter, float& exit) {
+    const float infinity = std::numeric_limits<float>::infinity();
+    if (move == 0.0f) {
+        bool overlap = movingMin < staticMin + staticSize && staticMin < movingMin + movingSize;
+        enter = overlap ? -infinity : infinity;
+        exit = overlap ? infinity : -infinity;
+        return;
+    }
+    float inverseMove = 1.0f / move;
+    float toFarEdge = (staticMin + staticSize - movingMin) * inverseMove;
+    float toNearEdge = (staticMin - movingSize - movingMin) * inverseMove;
+    enter = std::min(toNearEdge, toFarEdge);
+    exit = std::max(toNearEdge, toFarEdge);
+}
+
+// Interval of t over which an obstacle on the ground (left edge moving
+// from obstacleLeftStart to obstacleLeftEnd) overlaps the column at
+// PLAYER_X every runner stands in. Worked out once per obstacle and frame.
+inline void sweptColumnInterval(int obstacleLeftStart, int obstacleLeftEnd, int obstacleWidth,
+                                float& enterX, float& exitX) {
+    // Work in the obstacle's frame: the player moves right as the obstacle moves left
+    sweptAxisInterval(static_cast<float>(PLAYER_X), static_cast<float>(PLAYER_WIDTH),
+                      static_cast<float>(obstacleLeftStart - obstacleLeftEnd),
+                      static_cast<float>(obstacleLeftStart), static_cast<float>(obstacleWidth), enterX, exitX);
+}
+
+// The vertical half of the test, for a runner whose top moves from
+// playerTopStart to playerTopEnd, given the obstacle's column interval
+inline bool sweptRunnerHit(int playerTopStart, int playerTopEnd, int obstacleHeight,
+                           float enterX, float exitX, float& timeOfImpact) {
+    float enterY, exitY;
+    sweptAxisInterval(static_cast<float>(playerTopStart), static_cast<float>(PLAYER_HEIGHT),
+                      static_cast<float>(playerTopEnd - playerTopStart),
+                      static_cast<float>(GROUND_LEVEL - obstacleHeight), static_cast<float>(obstacleHeight), enterY, exitY);
+
+    float first = std::max(std::max(enterX, enterY), 0.0f);
+    float last = std::min(std::min(exitX, exitY), 1.0f);
+    timeOfImpact = first;
+    return first < last;
+}
+
+// Tests the player (fixed x, top moving from playerTopStart to playerTopEnd)
+// against an obstacle on the ground (left edge moving from obstacleLeftStart
+// to obstacleLeftEnd). Returns true when they overlap at some t in [0, 1],
+// with timeOfImpact set to the earliest such t.
+inline bool sweptPlayerHit(int playerTopStart, int playerTopEnd, int obstacleLeftStart, int obstacleLeftEnd,
+                           int obstacleWidth, int obstacleHeight, float& timeOfImpact) {
+    float enterX, exitX;
+    sweptColumnInterval(obstacleLeftStart, obstacleLeftEnd, obstacleWidth, enterX, exitX);
+    return sweptRunnerHit(playerTopStart, playerTopEnd, obstacleHeight, enterX, exitX, timeOfImpact);
+}
+
+#endif // SWEPT_COLLISION_H
@@ -0,0 +1,48 @@
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include <cstdint>
+
+// On-disk layout of a telemetry log written by the game and read by
+// telemetry_reader. A log is one TelemetryHeader followed by fixed-size
+// TelemetryRecords, so a mapped file can be walked as a plain array.
+// All fields are little-endian.
+
+const char TELEMETRY_MAGIC[4] = {'C', 'R', 'T', 'L'};
+const uint16_t TELEMETRY_VERSION = 1;
+
+enum TelemetryEventKind : uint8_t {
+    TELEMETRY_RUN_START = 1,   // arg1 = run index within the session, arg2 = low bits of the course seed
+    TELEMETRY_JUMP,            // arg1 = score at take-off
+    TELEMETRY_SCORED_JUMP,     // arg1 = score after the jump was counted
+    TELEMETRY_SPAWN,           // obstacleType, arg1 = width, arg2 = height
+    TELEMETRY_SPEED_UP,        // arg1 = new game speed, arg2 = course distance
+    TELEMETRY_DEATH,           // obstacleType, arg1 = final score, arg2 = obstacle x
+    TELEMETRY_EVENT_KIND_COUNT
+};
+
+#pragma pack(push, 1)
+struct TelemetryHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t recordSize;       // sizeof(TelemetryRecord), lets readers skip unknown tails
+    uint64_t startUnixTime;
+    uint64_t recordCount;      // 0 if the game did not shut down cleanly
+    uint32_t droppedCount;     // events lost because the ring buffer was full
+    uint32_t reserved;
+};
+
+struct TelemetryRecord {
+    uint32_t timeMs;           // SDL_GetTicks() when the event happened
+    uint8_t kind;              // TelemetryEventKind
+    uint8_t obstacleType;      // ObstacleType, or 0xFF when not applicable
+    uint16_t reserved;
+    int32_t arg1;
+    int32_t arg2;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TelemetryHeader) == 32, "TelemetryHeader must stay 32 bytes");
+static_assert(sizeof(TelemetryRecord) == 16, "TelemetryRecord must stay 16 bytes");
+
+#endif // TELEMETRY_FORMAT_H
@@ -0,0 +1,158 @@
+// Offline aggregator for the telemetry logs written by the game.
+// Usage: telemetry_reader telemetry_*.crtl
+//
+// Each log is memory-mapped and walked as an array of fixed-size
+// records, so aggregating many logs costs little more than reading them.
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "game_constants.h"
+#include "mapped_file.h"
+#include "telemetry_format.h"
+
+const char* OBSTACLE_NAMES[OBSTACLE_TYPE_COUNT] = {
+    "Coffee cup", "Briefcase", "Fire hydrant", "Trash can", "Car", "Bicycle", "Puddle", "Dog"
+};
+
+struct Totals {
+    uint64_t logs = 0;
+    uint64_t records = 0;
+    uint64_t dropped = 0;
+    uint64_t runs = 0;
+    uint64_t deaths = 0;
+    uint64_t jumps = 0;
+    uint64_t scoredJumps = 0;
+    uint64_t speedUps = 0;
+    uint64_t totalScore = 0;
+    uint64_t totalRunMs = 0;
+    int bestScore = 0;
+    int topSpeed = GAME_SPEED_INITIAL;
+    uint64_t spawnsByType[OBSTACLE_TYPE_COUNT] = {};
+    uint64_t deathsByType[OBSTACLE_TYPE_COUNT] = {};
+};
+
+bool aggregateLog(const std::string& path, Totals& totals) {
+    MappedFile log;
+    if (!log.open(path)) {
+        std::cerr << path << ": could not map file" << std::endl;
+        return false;
+    }
+    if (log.size() < sizeof(TelemetryHeader)) {
+        std::cerr << path << ": too short for a telemetry header" << std::endl;
+        return false;
+    }
+
+    TelemetryHeader header;
+    std::memcpy(&header, log.data(), sizeof(header));
+    if (std::memcmp(header.magic, TELEMETRY_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << path << ": not a telemetry log" << std::endl;
+        return false;
+    }
+    if (header.version != TELEMETRY_VERSION || header.recordSize < sizeof(TelemetryRecord)) {
+        std::cerr << path << ": unsupported telemetry version " << header.version << std::endl;
+        return false;
+    }
+
+    // A log from a crashed session has no count, so trust the file size instead
+    uint64_t available = (log.size() - sizeof(TelemetryHeader)) / header.recordSize;
+    uint64_t count = header.recordCount != 0 && header.recordCount < available ? header.recordCount : available;
+
+    const unsigned char* cursor = log.data() + sizeof(TelemetryHeader);
+    bool runOpen = false;
+    uint32_t runStartMs = 0;
+    for (uint64_t i = 0; i < count; i++, cursor += header.recordSize) {
+        TelemetryRecord record;
+        std::memcpy(&record, cursor, sizeof(record));
+        bool validType = record.obstacleType < OBSTACLE_TYPE_COUNT;
+
+        switch (record.kind) {
+            case TELEMETRY_RUN_START:
+                totals.runs++;
+                runOpen = true;
+                runStartMs = record.timeMs;
+                break;
+            case TELEMETRY_JUMP:
+                totals.jumps++;
+                break;
+            case TELEMETRY_SCORED_JUMP:
+                totals.scoredJumps++;
+                break;
+            case TELEMETRY_SPAWN:
+                if (validType) {
+                    totals.spawnsByType[record.obstacleType]++;
+                }
+                break;
+            case TELEMETRY_SPEED_UP:
+                totals.speedUps++;
+                totals.topSpeed = std::max(totals.topSpeed, static_cast<int>(record.arg1));
+                break;
+            case TELEMETRY_DEATH:
+                totals.deaths++;
+                totals.totalScore += static_cast<uint64_t>(record.arg1);
+                totals.bestScore = std::max(totals.bestScore, static_cast<int>(record.arg1));
+                if (validType) {
+                    totals.deathsByType[record.obstacleType]++;
+                }
+                if (runOpen) {
+                    totals.totalRunMs += record.timeMs - runStartMs;
+                    runOpen = false;
+                }
+                break;
+            default:
+                break;  // Unknown kinds from newer writers are skipped
+        }
+    }
+
+    totals.logs++;
+    totals.records += count;
+    totals.dropped += header.droppedCount;
+    return true;
+}
+
+void printTotals(const Totals& totals) {
+    std::cout << "Logs:          " << totals.logs << " (" << totals.records << " events, "
+              << totals.dropped << " dropped)" << std::endl;
+    std::cout << "Runs:          " << totals.runs << " (" << totals.deaths << " ended in a crash)" << std::endl;
+    std::cout << "Jumps:         " << totals.jumps << " (" << totals.scoredJumps << " scored)" << std::endl;
+    std::cout << "Speed-ups:     " << totals.speedUps << ", top speed " << totals.topSpeed << std::endl;
+    std::cout << "Best score:    " << totals.bestScore << std::endl;
+    if (totals.deaths > 0) {
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Average score: " << static_cast<double>(totals.totalScore) / totals.deaths << std::endl;
+        std::cout << "Average run:   " << static_cast<double>(totals.totalRunMs) / totals.deaths / 1000.0
+                  << " s" << std::endl;
+    }
+
+    std::cout << std::endl << std::left << std::setw(14) << "Obstacle" << std::right
+              << std::setw(10) << "Spawned" << std::setw(10) << "Deaths" << std::setw(10) << "Lethal" << std::endl;
+    for (int type = 0; type < OBSTACLE_TYPE_COUNT; type++) {
+        double lethality = totals.spawnsByType[type] > 0
+            ? 100.0 * totals.deathsByType[type] / totals.spawnsByType[type] : 0.0;
+        std::cout << std::left << std::setw(14) << OBSTACLE_NAMES[type] << std::right
+                  << std::setw(10) << totals.spawnsByType[type]
+                  << std::setw(10) << totals.deathsByType[type]
+                  << std::setw(9) << std::fixed << std::setprecision(1) << lethality << "%" << std::endl;
+    }
+}
+
+int main(int argc, char* args[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << args[0] << " <telemetry log>..." << std::endl;
+        return 1;
+    }
+
+    Totals totals;
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!aggregateLog(args[i], totals)) {
+            failures++;
+        }
+    }
+
+    printTotals(totals);
+    return failures == 0 ? 0 : 2;
+}